@@ -0,0 +1,186 @@
+/*
+ * Frame time benchmark for the scene renderer.
+ * Compares the original per-frame walk over the mapped Elements (list copy, Shape copies)
+ * with the CompiledScene arrays, at 10k and 100k shapes, then with 100k shapes laid out over
+ * 50 times the viewport area to measure culling. Every frame is measured twice: drawn into
+ * a raster surface, and into an SkNoDrawCanvas to isolate command generation.
+ * Finally 50k user rectangles are drawn one drawRect at a time, as the demo used to, through
+ * a RectBatch, and from the tiles of a RectLayer.
+ * Before measuring, it checks that distinct gradient shaders get distinct paints.
+ *
+ * Build with `compile.sh bench` and run with `node out/release/scene_bench.js`.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkSurface.h"
+#include "include/core/SkTypeface.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/utils/SkNoDrawCanvas.h"
+#include "include/utils/SkRandom.h"
+
+#include "../fonts.h"
+#include "../scene/compiled_scene.h"
+#include "../scene/paint_table.h"
+#include "../scene/rect_batch.h"
+#include "../scene/rect_layer.h"
+#include "../scene/scene_data.h"
+
+static const int kWidth = 1280;
+static const int kHeight = 720;
+
+// Shapes spread over `area` times the viewport
+static Elements make_elements(int count, int area) {
+	const int width = static_cast<int>(kWidth * std::sqrt(area));
+	const int height = static_cast<int>(kHeight * std::sqrt(area));
+
+	Elements elements;
+	for (int i = 0; i < count; ++i) {
+		Shape shape{};
+		shape.props.x = (i * 37) % width;
+		shape.props.y = (i * 91) % height;
+		if (i % 4 == 3) {
+			shape.type = ShapeType::Text;
+			shape.value = "World is beautiful!";
+		} else {
+			shape.type = ShapeType::Rectangle;
+			shape.props.width = 8 + i % 24;
+			shape.props.height = 8 + i % 16;
+		}
+		elements.elements.push_back(shape);
+	}
+	return elements;
+}
+
+// The frame loop as it was before the scene was compiled
+static void draw_elements(SkCanvas* canvas, const Elements& elements, const SkFont& font) {
+	SkPaint paint;
+	std::list <Shape> shapes = elements.elements;
+	for (Shape shape : shapes) {
+		if (shape.type == ShapeType::Rectangle) {
+			SkRect rectFromFile = SkRect::MakeXYWH(shape.props.x, shape.props.y, shape.props.width, shape.props.height);
+			paint.setColor(SK_ColorYELLOW);
+			canvas->drawRect(rectFromFile, paint);
+		}else if (shape.type == ShapeType::Text) {
+			paint.setColor(SK_ColorBLACK);
+			canvas->drawString(shape.value.c_str(), shape.props.x, shape.props.y, font, paint);
+		}
+	}
+}
+
+// Average milliseconds per frame
+static double time_frames(int frames, SkCanvas* canvas, const std::function<void(SkCanvas*)>& drawFrame) {
+	drawFrame(canvas);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < frames; ++i) {
+		canvas->clear(SK_ColorWHITE);
+		drawFrame(canvas);
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+}
+
+// Every gradient must keep its own paint, and the same shader must keep getting the same one
+static bool check_shader_fills() {
+	const SkPoint points[2] = {SkPoint::Make(0, 0), SkPoint::Make(100, 0)};
+	const SkColor red[2] = {SK_ColorRED, SK_ColorWHITE};
+	const SkColor blue[2] = {SK_ColorBLUE, SK_ColorWHITE};
+	sk_sp<SkShader> first = SkGradientShader::MakeLinear(points, red, nullptr, 2, SkTileMode::kClamp);
+	sk_sp<SkShader> second = SkGradientShader::MakeLinear(points, blue, nullptr, 2, SkTileMode::kClamp);
+
+	PaintTable paints;
+	uint32_t firstFill = paints.fill(first);
+	uint32_t secondFill = paints.fill(second);
+	return firstFill != secondFill && paints.fill(first) == firstFill && paints.fill(second) == secondFill;
+}
+
+int main() {
+	if (!check_shader_fills()) {
+		printf("EMSC:: Distinct gradient shaders share a paint\n");
+		return 1;
+	}
+
+	SkFont font(SkTypeface::MakeFromData(SkData::MakeWithoutCopy(dataKarlaRegular, sizeof(dataKarlaRegular))), 24);
+
+	sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(kWidth, kHeight);
+	SkNoDrawCanvas noDrawCanvas(kWidth, kHeight);
+
+	printf("%8s  %6s  %-9s  %12s  %12s  %8s\n", "shapes", "area", "target", "before (ms)", "after (ms)", "speedup");
+
+	struct Layout {
+		int count;
+		int area;
+	};
+	for (const Layout& layout : {Layout{10000, 1}, Layout{100000, 1}, Layout{100000, 50}}) {
+		const int count = layout.count;
+		Elements elements = make_elements(count, layout.area);
+		CompiledScene scene;
+		scene.build(elements, font);
+
+		const int frames = count >= 100000 ? 10 : 50;
+
+		auto before = [&](SkCanvas* canvas) { draw_elements(canvas, elements, font); };
+		auto after = [&](SkCanvas* canvas) { scene.draw(canvas); };
+
+		struct Target {
+			const char* name;
+			SkCanvas* canvas;
+		};
+		for (const Target& target : {Target{"raster", surface->getCanvas()}, Target{"commands", &noDrawCanvas}}) {
+			double beforeMs = time_frames(frames, target.canvas, before);
+			double afterMs = time_frames(frames, target.canvas, after);
+			printf("%8d  %5dx  %-9s  %12.3f  %12.3f  %7.2fx\n", count, layout.area, target.name, beforeMs, afterMs, beforeMs / afterMs);
+		}
+	}
+
+	printf("\n%8s  %-9s  %13s  %12s  %12s\n", "rects", "target", "drawRect (ms)", "batch (ms)", "layer (ms)");
+
+	const int rectCount = 50000;
+	std::vector<SkRect> rects;
+	std::vector<SkColor> colors;
+	RectBatch batch;
+	RectLayer layer;
+	SkRandom rand;
+	for (int i = 0; i < rectCount; ++i) {
+		float x = rand.nextRangeF(0, kWidth);
+		float y = rand.nextRangeF(0, kHeight);
+		rects.push_back(SkRect::MakeXYWH(x, y, rand.nextRangeF(4, 200), rand.nextRangeF(4, 200)));
+		colors.push_back(rand.nextU() | 0x44808080);
+		batch.add(rects.back(), colors.back());
+		layer.add(rects.back(), colors.back());
+	}
+	layer.bake(surface->getCanvas());
+
+	auto before = [&](SkCanvas* canvas) {
+		SkPaint paint;
+		for (int i = 0; i < rectCount; ++i) {
+			paint.setColor(colors[i]);
+			canvas->drawRect(rects[i], paint);
+		}
+	};
+	auto batched = [&](SkCanvas* canvas) { batch.draw(canvas); };
+	auto baked = [&](SkCanvas* canvas) { layer.draw(canvas); };
+
+	struct Target {
+		const char* name;
+		SkCanvas* canvas;
+	};
+	for (const Target& target : {Target{"raster", surface->getCanvas()}, Target{"commands", &noDrawCanvas}}) {
+		double beforeMs = time_frames(10, target.canvas, before);
+		double batchMs = time_frames(10, target.canvas, batched);
+		double layerMs = time_frames(10, target.canvas, baked);
+		printf("%8d  %-9s  %13.3f  %12.3f  %12.3f\n", rectCount, target.name, beforeMs, batchMs, layerMs);
+	}
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Scaling benchmark for TiledRasterizer.
+ * Renders a 16384x8192 scene with 200k shapes, recorded once into an SkPicture, with 1 to 32
+ * threads and prints the time and speedup against one thread for each tile size.
+ *
+ *   tile_bench [tile]...
+ *
+ * Tile sizes default to 256, 512 and 1024. Build natively with `compile_native.sh`.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+
+#include "../scene/scene_data.h"
+#include "../scene/scene_renderer.h"
+#include "../scene/tiled_rasterizer.h"
+#include "../scene/worker_pool.h"
+
+static const int kWidth = 16384;
+static const int kHeight = 8192;
+static const int kShapes = 200000;
+
+static Elements make_elements() {
+	Elements elements;
+	for (int i = 0; i < kShapes; ++i) {
+		Shape shape{};
+		shape.props.x = (i * 37) % kWidth;
+		shape.props.y = (i * 91) % kHeight;
+		if (i % 4 == 3) {
+			shape.type = ShapeType::Text;
+			shape.value = "World is beautiful!";
+		} else {
+			shape.type = ShapeType::Rectangle;
+			shape.props.width = 8 + i % 120;
+			shape.props.height = 8 + i % 80;
+			shape.strokeColor = i % 2 ? "black" : "";
+			shape.strokeWidth = 2;
+		}
+		elements.elements.push_back(shape);
+	}
+	return elements;
+}
+
+int main(int argc, char** argv) {
+	std::vector<int> tileSizes;
+	for (int i = 1; i < argc; ++i) {
+		tileSizes.push_back(atoi(argv[i]));
+	}
+	if (tileSizes.empty()) {
+		tileSizes = {256, 512, 1024};
+	}
+
+	SceneRenderer scene;
+	scene.setElements(make_elements());
+	sk_sp<SkPicture> picture = scene.picture(SkRect::MakeIWH(kWidth, kHeight));
+
+	SkImageInfo info = SkImageInfo::MakeN32Premul(kWidth, kHeight);
+	std::vector<char> pixels(info.computeMinByteSize());
+	SkPixmap pixmap(info, pixels.data(), info.minRowBytes());
+
+	printf("%6s  %7s  %10s  %8s\n", "tile", "threads", "time (ms)", "speedup");
+	for (int tile : tileSizes) {
+		double oneThreadMs = 0;
+		for (int threads : {1, 2, 4, 8, 16, 32}) {
+			WorkerPool pool(threads);
+			TiledRasterizer::Options options;
+			options.tileWidth = tile;
+			options.tileHeight = tile;
+			TiledRasterizer rasterizer(pool, options);
+
+			auto start = std::chrono::steady_clock::now();
+			rasterizer.render(*picture, 1, pixmap);
+			double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (threads == 1) {
+				oneThreadMs = ms;
+			}
+			printf("%6d  %7d  %10.1f  %7.2fx\n", tile, threads, ms, oneThreadMs / ms);
+		}
+	}
+
+	return 0;
+}
@@ -36,6 +36,11 @@ mkdir -p $BUILD_DIR
 
 WASM_GPU="-lEGL -lGLESv2 -DSK_SUPPORT_GPU=1 -DSK_GL -DSK_DISABLE_LEGACY_SHADERCONTEXT"
 
+# The scene is built on a loader thread. libskia.a is compiled with -pthread as well, wasm-ld
+# refuses to mix objects with and without shared memory, so every target here uses threads.
+# Browsers only allow them on cross origin isolated pages, serve.py sends the headers.
+PTHREADS="-pthread -s USE_PTHREADS=1"
+
 # Emscripten prefers that the .a files go last in order, otherwise, it
 # may drop symbols that it incorrectly thinks aren't used. One day,
 # Emscripten will use LLD, which may relax this requirement.
@@ -67,12 +72,85 @@ WASM_GPU="-lEGL -lGLESv2 -DSK_SUPPORT_GPU=1 -DSK_GL -DSK_DISABLE_LEGACY_SHADERCO
 # NOTE: Had to set ERROR_ON_UNDEFINED_SYMBOLS to 0, to workaround linker errors :(
 #
 # SK_BUILD_FOR_WASM is our own symbol, nothing to do with Skia.
+SCENE_SOURCES="\
+    ./scene/compiled_scene.cpp \
+    ./scene/damage_tracker.cpp \
+    ./scene/paint_table.cpp \
+    ./scene/raster_backend.cpp \
+    ./scene/rect_batch.cpp \
+    ./scene/rect_layer.cpp \
+    ./scene/redraw_scheduler.cpp \
+    ./scene/resolution_scaler.cpp \
+    ./scene/scene_loader.cpp \
+    ./scene/scene_picture.cpp \
+    ./scene/scene_renderer.cpp \
+    ./scene/shader_cache.cpp \
+    ./scene/spatial_index.cpp \
+    ./scene/sprite_atlas.cpp \
+    ./scene/surface_pool.cpp \
+    ./scene/text_blob_cache.cpp \
+    ./scene/tiled_rasterizer.cpp \
+    ./scene/typeface_registry.cpp \
+    ./scene/worker_pool.cpp"
+
+# Benchmarks are console programs meant to be run with node, so they skip SDL and the
+# asset bundle and are always optimized: `compile.sh bench`
+if [[ $@ == *bench* ]]; then
+  ${EMCXX} \
+      -I . \
+      -I ~/skia/include/core \
+      -I ~/skia/include/effects \
+      -I ~/skia \
+      -std=c++17 \
+      -O3 \
+      -DSK_RELEASE \
+      ${PTHREADS} \
+      -s WASM=1 \
+      -s ALLOW_MEMORY_GROWTH=1 \
+      -s INITIAL_MEMORY=128MB \
+      -s ERROR_ON_UNDEFINED_SYMBOLS=0 \
+      ${WASM_GPU} \
+      ${EXTERNALS_FOLDER}/libskia.a \
+      -o $BUILD_DIR/scene_bench.js \
+      ./bench/scene_bench.cpp \
+      ${SCENE_SOURCES}
+  exit 0
+fi
+
+# The headless renderer draws into a raster surface, it needs neither SDL nor GL. NODERAWFS
+# gives it the real file system when run with node: `compile.sh headless`, then
+# `node out/release/render_scene.js scene.json scene.png`
+if [[ $@ == *headless* ]]; then
+  ${EMCXX} \
+      -I . \
+      -I ~/skia/include/core \
+      -I ~/skia/include/effects \
+      -I ~/skia \
+      -std=c++17 \
+      -O3 \
+      -DSK_RELEASE \
+      ${PTHREADS} \
+      -s WASM=1 \
+      -s ALLOW_MEMORY_GROWTH=1 \
+      -s INITIAL_MEMORY=128MB \
+      -s NODERAWFS=1 \
+      -s EXIT_RUNTIME=1 \
+      -s ERROR_ON_UNDEFINED_SYMBOLS=0 \
+      ${EXTERNALS_FOLDER}/libskia.a \
+      -o $BUILD_DIR/render_scene.js \
+      ./tools/render_scene.cpp \
+      ${SCENE_SOURCES}
+  exit 0
+fi
+
 ${EMCXX} \
     -I . \
     -I ~/skia/include/core \
     -I ~/skia/include/effects \
     -I ~/skia \
     -std=c++17 \
+    ${PTHREADS} \
+    -s PTHREAD_POOL_SIZE=1 \
     -s WASM=1 \
     -s USE_SDL=2 \
     -s ALLOW_MEMORY_GROWTH=1 \
@@ -90,7 +168,8 @@ ${EMCXX} \
     ${RELEASE_CONF} \
     ${EXTERNALS_FOLDER}/libskia.a \
     -o $BUILD_DIR/index.html \
-    ./main.cpp
+    ./main.cpp \
+    ${SCENE_SOURCES}
 
 # Test
 # node $BUILD_DIR/index.js
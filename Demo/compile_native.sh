@@ -0,0 +1,54 @@
+#!/bin/bash
+
+# Builds the headless tools for the host, against the libskia.a of Skia/compile_native.sh.
+# They render with the CPU raster backend and need no display, SDL or GL.
+
+set -ex
+
+if [[ $@ == *debug* ]]; then
+  echo "Building a Debug build"
+  RELEASE_CONF="-O0 -g -DSK_DEBUG"
+  EXTERNALS_FOLDER=${EXTERNALS_FOLDER:="/externals-native/debug"}
+  BUILD_DIR=${BUILD_DIR:="out/native/debug"}
+else
+  echo "Building a Release build"
+  RELEASE_CONF="-O3 -DSK_RELEASE"
+  EXTERNALS_FOLDER=${EXTERNALS_FOLDER:="/externals-native/release"}
+  BUILD_DIR=${BUILD_DIR:="out/native/release"}
+fi
+
+mkdir -p $BUILD_DIR
+
+CXX=${CXX:=clang++}
+
+SCENE_SOURCES="\
+    ./scene/compiled_scene.cpp \
+    ./scene/paint_table.cpp \
+    ./scene/raster_backend.cpp \
+    ./scene/scene_picture.cpp \
+    ./scene/scene_renderer.cpp \
+    ./scene/shader_cache.cpp \
+    ./scene/spatial_index.cpp \
+    ./scene/surface_pool.cpp \
+    ./scene/text_blob_cache.cpp \
+    ./scene/tiled_rasterizer.cpp \
+    ./scene/typeface_registry.cpp \
+    ./scene/worker_pool.cpp"
+
+# Skia's own dependencies are linked into libskia.a
+LIBS="${EXTERNALS_FOLDER}/libskia.a -lpthread -ldl"
+
+for TOOL in tools/render_scene tools/batch_render tools/render_server bench/tile_bench; do
+  ${CXX} \
+      -I . \
+      -I ~/skia/include/core \
+      -I ~/skia/include/effects \
+      -I ~/skia \
+      -std=c++17 \
+      -pthread \
+      ${RELEASE_CONF} \
+      -o $BUILD_DIR/$(basename ${TOOL}) \
+      ./${TOOL}.cpp \
+      ${SCENE_SOURCES} \
+      ${LIBS}
+done
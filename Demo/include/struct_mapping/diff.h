@@ -0,0 +1,305 @@
+#pragma once
+
+#include "hash.h"
+#include "iterate_over.h"
+#include "member_string.h"
+#include "object.h"
+#include "object_array_like.h"
+#include "object_map_like.h"
+#include "utility.h"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+namespace struct_mapping::detail
+{
+
+template<typename V>
+void iterate_over_value(V& value, const std::string& name)
+{
+	if constexpr (is_optional_v<V>)
+	{
+		if (value.has_value())
+		{
+			iterate_over_value(value.value(), name);
+		}
+		else
+		{
+			IterateOver::set_null(name);
+		}
+	}
+	else if constexpr (std::is_same_v<V, bool>)
+	{
+		IterateOver::set<bool>(name, value);
+	}
+	else if constexpr (std::is_integral_v<V>)
+	{
+		IterateOver::set<long long>(name, value);
+	}
+	else if constexpr (std::is_floating_point_v<V>)
+	{
+		IterateOver::set<double>(name, value);
+	}
+	else if constexpr (std::is_same_v<V, std::string>)
+	{
+		IterateOver::set<std::string>(name, value);
+	}
+	else if constexpr (std::is_enum_v<V>)
+	{
+		IterateOver::set<std::string>(name, MemberString<V>::to_string(name)(value));
+	}
+	else if constexpr (is_array_like_v<V> || is_map_like_v<V>)
+	{
+		Object<V>::iterate_over(value, name);
+	}
+	else
+	{
+		if (IsMemberStringExist<V>::value)
+		{
+			IterateOver::set<std::string>(name, MemberString<V>::to_string(name)(value));
+		}
+		else
+		{
+			Object<V>::iterate_over(value, name);
+		}
+	}
+}
+
+// Writes the operations of a JSON Patch (RFC 6902) as one JSON array. Values are written by the
+// IterateOver writer installed for the call, compactly; a non-empty indent puts every operation on
+// its own line.
+class PatchWriter
+{
+public:
+	PatchWriter(std::basic_ostream<char>& json_data_, const std::string& indent_, JsonWriterState& state_)
+		:	json_data(json_data_),
+			indent(indent_),
+			state(state_)
+	{
+		json_data << "[";
+	}
+
+	PatchWriter(const PatchWriter&) = delete;
+	PatchWriter& operator=(const PatchWriter&) = delete;
+
+	~PatchWriter()
+	{
+		if (!indent.empty() && !first_op)
+		{
+			json_data << "\n";
+		}
+
+		json_data << "]";
+	}
+
+	template<typename V>
+	void add(const std::string& path, const V& value)
+	{
+		write_op("add", path);
+		write_value(value);
+	}
+
+	template<typename V>
+	void replace(const std::string& path, const V& value)
+	{
+		write_op("replace", path);
+		write_value(value);
+	}
+
+	void remove(const std::string& path)
+	{
+		write_op("remove", path);
+		json_data << "}";
+	}
+
+private:
+	void write_op(const char* op, const std::string& path)
+	{
+		if (!first_op)
+		{
+			json_data << ",";
+		}
+
+		if (!indent.empty())
+		{
+			json_data << "\n" << indent;
+		}
+
+		json_data << "{\"op\":\"" << op << "\",\"path\":\"" << path << "\"";
+		first_op = false;
+	}
+
+	template<typename V>
+	void write_value(const V& value)
+	{
+		json_data << ",\"value\":";
+
+		state.first_element = true;
+		state.indent_count = 0;
+		// The writer only reads the value
+		iterate_over_value(const_cast<V&>(value), "");
+
+		json_data << "}";
+	}
+
+private:
+	std::basic_ostream<char>& json_data;
+	const std::string& indent;
+	JsonWriterState& state;
+	bool first_op = true;
+};
+
+// Appends one reference token to a JSON Pointer (RFC 6901)
+inline void append_pointer_token(std::string& path, const std::string& token)
+{
+	path += '/';
+
+	for (const char c : token)
+	{
+		if (c == '~')
+		{
+			path += "~0";
+		}
+		else if (c == '/')
+		{
+			path += "~1";
+		}
+		else
+		{
+			path += c;
+		}
+	}
+}
+
+template<typename V>
+void diff_value(const V& baseline, const V& current, std::string& path, PatchWriter& patch);
+
+template<typename V>
+void diff_member(const V& baseline, const V& current, const std::string& name, std::string& path, PatchWriter& patch)
+{
+	const std::size_t length = path.size();
+
+	append_pointer_token(path, name);
+	diff_value(baseline, current, path, patch);
+	path.resize(length);
+}
+
+// Emits the operations that turn baseline into current at path: nothing when the values are equal,
+// per member operations for structs and maps, per index operations for sequences (elements are
+// compared by position, extra ones added at the end or removed from the end) and a replace of the
+// whole value otherwise.
+template<typename V>
+void diff_value(const V& baseline, const V& current, std::string& path, PatchWriter& patch)
+{
+	if (equal_value(baseline, current))
+	{
+		return;
+	}
+
+	if constexpr (is_optional_v<V>)
+	{
+		if (baseline.has_value() && current.has_value())
+		{
+			diff_value(baseline.value(), current.value(), path, patch);
+		}
+		else if (current.has_value())
+		{
+			patch.add(path, current.value());
+		}
+		else
+		{
+			patch.remove(path);
+		}
+	}
+	else if constexpr (is_map_like_v<V>)
+	{
+		for (const auto& [k, v] : baseline)
+		{
+			if (current.find(k) == current.end())
+			{
+				const std::size_t length = path.size();
+
+				append_pointer_token(path, k);
+				patch.remove(path);
+				path.resize(length);
+			}
+		}
+
+		for (const auto& [k, v] : current)
+		{
+			if (auto it = baseline.find(k); it != baseline.end())
+			{
+				diff_member(it->second, v, k, path, patch);
+			}
+			else
+			{
+				const std::size_t length = path.size();
+
+				append_pointer_token(path, k);
+				patch.add(path, v);
+				path.resize(length);
+			}
+		}
+	}
+	else if constexpr (is_array_like_v<V>)
+	{
+		if constexpr (has_key_type_v<V>)
+		{
+			// Set elements have no index to address
+			patch.replace(path, current);
+		}
+		else
+		{
+			std::size_t index = 0;
+			auto it_baseline = baseline.begin();
+			auto it_current = current.begin();
+
+			for (; it_baseline != baseline.end() && it_current != current.end(); ++it_baseline, ++it_current, ++index)
+			{
+				diff_member(*it_baseline, *it_current, std::to_string(index), path, patch);
+			}
+
+			const std::size_t length = path.size();
+			std::size_t baseline_size = index;
+
+			for (; it_baseline != baseline.end(); ++it_baseline)
+			{
+				++baseline_size;
+			}
+
+			// Removed from the end first, so the indices of the remaining elements stay valid
+			for (std::size_t i = baseline_size; i > index; --i)
+			{
+				append_pointer_token(path, std::to_string(i - 1));
+				patch.remove(path);
+				path.resize(length);
+			}
+
+			for (; it_current != current.end(); ++it_current, ++index)
+			{
+				append_pointer_token(path, std::to_string(index));
+				patch.add(path, *it_current);
+				path.resize(length);
+			}
+		}
+	}
+	else if constexpr (is_complex_v<V>)
+	{
+		if (IsMemberStringExist<V>::value)
+		{
+			patch.replace(path, current);
+		}
+		else
+		{
+			Object<V>::diff(baseline, current, path, patch);
+		}
+	}
+	else
+	{
+		patch.replace(path, current);
+	}
+}
+
+} // struct_mapping::detail
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "hasher.h"
+#include "object.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace struct_mapping
+{
+
+namespace detail
+{
+
+class ElementHashScope;
+
+} // detail
+
+// Digests gathered while mapping: for every array of structs that is a direct member of the mapped
+// struct, one digest per element in document order. Each element is hashed as soon as it is mapped,
+// so a digest always equals hash() of that element and elements unchanged since the previous load
+// can be found by comparing digests, without another pass over the mapped structs.
+class ElementHashes
+{
+	friend class detail::ElementHashScope;
+
+public:
+	// Digests of the elements of the array member called name, empty if the document had none
+	const std::vector<std::uint64_t>& of(const std::string& name) const
+	{
+		static const std::vector<std::uint64_t> empty;
+
+		const auto it = members.find(name);
+
+		return it == members.end() ? empty : it->second;
+	}
+
+	void clear()
+	{
+		members.clear();
+	}
+
+private:
+	std::unordered_map<std::string, std::vector<std::uint64_t>> members;
+};
+
+namespace detail
+{
+
+class ElementHashScope
+{
+public:
+	explicit ElementHashScope(ElementHashes& hashes)
+	{
+		hashes.clear();
+		current = &hashes;
+	}
+
+	ElementHashScope(const ElementHashScope&) = delete;
+	ElementHashScope& operator=(const ElementHashScope&) = delete;
+
+	~ElementHashScope()
+	{
+		current = nullptr;
+		sink = nullptr;
+		array_level = 0;
+		element_level = false;
+	}
+
+	// Called for the arrays opened while the mapped struct itself is the innermost struct
+	static void start_array(const std::string& name)
+	{
+		if (current != nullptr && ++array_level == 1)
+		{
+			sink = &current->members[name];
+		}
+	}
+
+	static void end_array()
+	{
+		if (current != nullptr && --array_level == 0)
+		{
+			sink = nullptr;
+		}
+	}
+
+	// Set before each struct is released: true when that struct is an element of a tracked array
+	static void set_element_level(bool element_level_)
+	{
+		element_level = element_level_ && array_level == 1;
+	}
+
+	template<typename V>
+	static void element_done(const V& element)
+	{
+		if (sink != nullptr && element_level)
+		{
+			Hasher hasher;
+			hash_value(hasher, element);
+			sink->push_back(hasher.digest());
+		}
+	}
+
+private:
+	static inline thread_local ElementHashes* current = nullptr;
+	static inline thread_local std::vector<std::uint64_t>* sink = nullptr;
+	static inline thread_local unsigned array_level = 0;
+	static inline thread_local bool element_level = false;
+};
+
+} // detail
+
+} // struct_mapping
@@ -0,0 +1,325 @@
+#pragma once
+
+#include "exception.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace struct_mapping
+{
+
+template<typename T>
+struct EnumEntry
+{
+	std::string_view name;
+	T value;
+};
+
+// Specialize with a `static constexpr EnumEntry<T> entries[]` list to map an enumeration without MemberString.
+// An optional `static constexpr T fallback` is returned for names missing from the list instead of
+// failing the whole mapping
+template<typename T>
+struct EnumNames;
+
+namespace detail
+{
+
+template<
+	typename,
+	typename = std::void_t<>>
+struct has_enum_names : std::false_type{};
+
+template<typename T>
+struct has_enum_names<T, std::void_t<decltype(EnumNames<T>::entries)>> : std::true_type{};
+
+template<typename T>
+constexpr bool has_enum_names_v = has_enum_names<T>::value;
+
+template<
+	typename,
+	typename = std::void_t<>>
+struct has_enum_fallback : std::false_type{};
+
+template<typename T>
+struct has_enum_fallback<T, std::void_t<decltype(EnumNames<T>::fallback)>> : std::true_type{};
+
+template<typename T>
+constexpr bool has_enum_fallback_v = has_enum_fallback<T>::value;
+
+constexpr std::uint64_t enum_name_hash(std::string_view name, std::uint64_t seed)
+{
+	std::uint64_t hash = 14695981039346656037ull ^ seed;
+
+	for (const char ch : name)
+	{
+		hash = (hash ^ static_cast<unsigned char>(ch)) * 1099511628211ull;
+	}
+
+	return hash ^ (hash >> 29);
+}
+
+constexpr std::size_t enum_table_buckets(std::size_t size)
+{
+	std::size_t buckets = 1;
+
+	while (buckets < size * 2)
+	{
+		buckets *= 2;
+	}
+
+	return buckets;
+}
+
+template<typename T>
+constexpr std::size_t enum_table_size = std::size(EnumNames<T>::entries);
+
+template<typename T>
+constexpr std::size_t enum_table_buckets_v = enum_table_buckets(enum_table_size<T>);
+
+template<typename T>
+constexpr bool enum_has_unique_names()
+{
+	constexpr auto& entries = EnumNames<T>::entries;
+
+	for (std::size_t i = 0; i < enum_table_size<T>; ++i)
+	{
+		for (std::size_t j = i + 1; j < enum_table_size<T>; ++j)
+		{
+			if (entries[i].name == entries[j].name)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// Values 0 .. size - 1, each exactly once: to_string can index an array
+template<typename T>
+constexpr bool enum_is_dense()
+{
+	std::array<bool, enum_table_size<T>> seen{};
+
+	for (const auto& entry : EnumNames<T>::entries)
+	{
+		const auto value = static_cast<long long>(static_cast<std::underlying_type_t<T>>(entry.value));
+
+		if (value < 0 || static_cast<std::size_t>(value) >= enum_table_size<T> || seen[static_cast<std::size_t>(value)])
+		{
+			return false;
+		}
+
+		seen[static_cast<std::size_t>(value)] = true;
+	}
+
+	return true;
+}
+
+template<typename T>
+constexpr bool enum_is_collision_free(std::uint64_t seed)
+{
+	std::array<bool, enum_table_buckets_v<T>> used{};
+
+	for (const auto& entry : EnumNames<T>::entries)
+	{
+		const auto bucket = enum_name_hash(entry.name, seed) & (enum_table_buckets_v<T> - 1);
+
+		if (used[bucket])
+		{
+			return false;
+		}
+
+		used[bucket] = true;
+	}
+
+	return true;
+}
+
+// Looks for a seed that gives a perfect hash; falls back to linear probing with seed 0
+template<typename T>
+constexpr std::uint64_t enum_find_seed()
+{
+	for (std::uint64_t seed = 0; seed != 64; ++seed)
+	{
+		if (enum_is_collision_free<T>(seed))
+		{
+			return seed;
+		}
+	}
+
+	return 0;
+}
+
+template<typename T>
+constexpr std::array<std::size_t, enum_table_buckets_v<T>> enum_make_slots(std::uint64_t seed)
+{
+	constexpr auto mask = enum_table_buckets_v<T> - 1;
+	std::array<std::size_t, enum_table_buckets_v<T>> result{};
+
+	for (std::size_t i = 0; i < enum_table_size<T>; ++i)
+	{
+		auto bucket = enum_name_hash(EnumNames<T>::entries[i].name, seed) & mask;
+
+		while (result[bucket] != 0)
+		{
+			bucket = (bucket + 1) & mask;
+		}
+
+		result[bucket] = i + 1;
+	}
+
+	return result;
+}
+
+template<typename T>
+constexpr std::array<std::string_view, enum_table_size<T>> enum_make_names()
+{
+	std::array<std::string_view, enum_table_size<T>> result{};
+
+	if constexpr (enum_is_dense<T>())
+	{
+		for (const auto& entry : EnumNames<T>::entries)
+		{
+			result[static_cast<std::size_t>(static_cast<std::underlying_type_t<T>>(entry.value))] = entry.name;
+		}
+	}
+
+	return result;
+}
+
+template<typename T>
+class EnumTable
+{
+public:
+	static_assert(enum_table_size<T> != 0, "EnumNames: entries cannot be empty");
+	static_assert(enum_has_unique_names<T>(), "EnumNames: names must be unique");
+
+public:
+	static constexpr std::optional<T> from_string(std::string_view name)
+	{
+		constexpr auto mask = enum_table_buckets_v<T> - 1;
+
+		for (std::size_t bucket = enum_name_hash(name, seed) & mask;; bucket = (bucket + 1) & mask)
+		{
+			const auto slot = slots[bucket];
+
+			if (slot == 0)
+			{
+				return std::nullopt;
+			}
+
+			if (EnumNames<T>::entries[slot - 1].name == name)
+			{
+				return EnumNames<T>::entries[slot - 1].value;
+			}
+		}
+	}
+
+	static constexpr std::optional<std::string_view> to_string(T value)
+	{
+		if constexpr (is_dense)
+		{
+			const auto index = static_cast<std::size_t>(static_cast<std::underlying_type_t<T>>(value));
+
+			if (index < enum_table_size<T>)
+			{
+				return names[index];
+			}
+		}
+		else
+		{
+			for (const auto& entry : EnumNames<T>::entries)
+			{
+				if (entry.value == value)
+				{
+					return entry.name;
+				}
+			}
+		}
+
+		return std::nullopt;
+	}
+
+private:
+	static constexpr bool is_dense = enum_is_dense<T>();
+	static constexpr std::uint64_t seed = enum_find_seed<T>();
+	static constexpr std::array<std::size_t, enum_table_buckets_v<T>> slots = enum_make_slots<T>(seed);
+	static constexpr std::array<std::string_view, enum_table_size<T>> names = enum_make_names<T>();
+};
+
+template<typename T>
+class EnumFromString
+{
+public:
+	// Holds a view of the member name for error reporting; invoke before the name goes out of scope
+	constexpr explicit EnumFromString(std::string_view name_)
+		:	name(name_) {}
+
+	T operator()(std::string_view value) const
+	{
+		if (const auto result = EnumTable<T>::from_string(value); result)
+		{
+			return result.value();
+		}
+
+		if constexpr (has_enum_fallback_v<T>)
+		{
+			return EnumNames<T>::fallback;
+		}
+		else
+		{
+			throw StructMappingException("bad value '" + std::string(value) + "' for member: " + std::string(name));
+		}
+	}
+
+private:
+	std::string_view name;
+};
+
+template<typename T>
+class EnumToString
+{
+public:
+	constexpr explicit EnumToString(std::string_view name_)
+		:	name(name_) {}
+
+	std::string operator()(T value) const
+	{
+		if (const auto result = EnumTable<T>::to_string(value); result)
+		{
+			return std::string(result.value());
+		}
+
+		throw StructMappingException(
+			"bad value "
+				+ std::to_string(static_cast<std::underlying_type_t<T>>(value))
+				+ " for member: "
+				+ std::string(name));
+	}
+
+private:
+	std::string_view name;
+};
+
+} // detail
+
+template<typename T>
+constexpr std::optional<T> enum_from_string(std::string_view name)
+{
+	return detail::EnumTable<T>::from_string(name);
+}
+
+template<typename T>
+constexpr std::optional<std::string_view> enum_to_string(T value)
+{
+	return detail::EnumTable<T>::to_string(value);
+}
+
+} // struct_mapping
\ No newline at end of file
@@ -0,0 +1,345 @@
+#pragma once
+
+#include "exception.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace struct_mapping
+{
+
+template<
+	typename Key,
+	typename T,
+	typename Compare = std::less<>,
+	typename Allocator = std::allocator<std::pair<Key, T>>>
+class FlatMap
+{
+public:
+	using key_type = Key;
+	using mapped_type = T;
+	using value_type = std::pair<Key, T>;
+	using key_compare = Compare;
+	using allocator_type = Allocator;
+	using container_type = std::vector<value_type, Allocator>;
+	using size_type = typename container_type::size_type;
+	using iterator = typename container_type::iterator;
+	using const_iterator = typename container_type::const_iterator;
+
+private:
+	template<
+		typename K,
+		typename = std::void_t<>>
+	struct is_transparent : std::false_type{};
+
+	template<typename K>
+	struct is_transparent<K, std::void_t<typename Compare::is_transparent>> : std::true_type{};
+
+	template<typename K>
+	using enable_if_transparent_t = std::enable_if_t<is_transparent<K>::value>;
+
+public:
+	FlatMap() = default;
+
+	explicit FlatMap(const Compare& compare_)
+		:	compare(compare_) {}
+
+	iterator begin() noexcept {return values.begin();}
+	const_iterator begin() const noexcept {return values.begin();}
+	const_iterator cbegin() const noexcept {return values.cbegin();}
+	iterator end() noexcept {return values.end();}
+	const_iterator end() const noexcept {return values.end();}
+	const_iterator cend() const noexcept {return values.cend();}
+
+	bool empty() const noexcept {return values.empty();}
+	size_type size() const noexcept {return values.size();}
+	size_type capacity() const noexcept {return values.capacity();}
+	void reserve(size_type capacity_) {values.reserve(capacity_);}
+	void shrink_to_fit() {values.shrink_to_fit();}
+	void clear() noexcept {values.clear();}
+
+	mapped_type& at(const key_type& key)
+	{
+		return at_impl(*this, key);
+	}
+
+	const mapped_type& at(const key_type& key) const
+	{
+		return at_impl(*this, key);
+	}
+
+	template<
+		typename K,
+		typename = enable_if_transparent_t<K>>
+	mapped_type& at(const K& key)
+	{
+		return at_impl(*this, key);
+	}
+
+	template<
+		typename K,
+		typename = enable_if_transparent_t<K>>
+	const mapped_type& at(const K& key) const
+	{
+		return at_impl(*this, key);
+	}
+
+	mapped_type& operator[](const key_type& key)
+	{
+		return try_emplace(key).first->second;
+	}
+
+	mapped_type& operator[](key_type&& key)
+	{
+		return try_emplace(std::move(key)).first->second;
+	}
+
+	size_type count(const key_type& key) const
+	{
+		return find(key) == end() ? 0 : 1;
+	}
+
+	template<
+		typename K,
+		typename = enable_if_transparent_t<K>>
+	size_type count(const K& key) const
+	{
+		return find(key) == end() ? 0 : 1;
+	}
+
+	bool contains(const key_type& key) const
+	{
+		return find(key) != end();
+	}
+
+	template<
+		typename K,
+		typename = enable_if_transparent_t<K>>
+	bool contains(const K& key) const
+	{
+		return find(key) != end();
+	}
+
+	iterator find(const key_type& key)
+	{
+		return find_impl(*this, key);
+	}
+
+	const_iterator find(const key_type& key) const
+	{
+		return find_impl(*this, key);
+	}
+
+	template<
+		typename K,
+		typename = enable_if_transparent_t<K>>
+	iterator find(const K& key)
+	{
+		return find_impl(*this, key);
+	}
+
+	template<
+		typename K,
+		typename = enable_if_transparent_t<K>>
+	const_iterator find(const K& key) const
+	{
+		return find_impl(*this, key);
+	}
+
+	iterator lower_bound(const key_type& key)
+	{
+		return lower_bound_impl(*this, key);
+	}
+
+	const_iterator lower_bound(const key_type& key) const
+	{
+		return lower_bound_impl(*this, key);
+	}
+
+	template<
+		typename K,
+		typename = enable_if_transparent_t<K>>
+	iterator lower_bound(const K& key)
+	{
+		return lower_bound_impl(*this, key);
+	}
+
+	template<
+		typename K,
+		typename = enable_if_transparent_t<K>>
+	const_iterator lower_bound(const K& key) const
+	{
+		return lower_bound_impl(*this, key);
+	}
+
+	template<typename ... Args>
+	std::pair<iterator, bool> emplace(Args&& ... args)
+	{
+		return insert(value_type(std::forward<Args>(args)...));
+	}
+
+	std::pair<iterator, bool> insert(const value_type& value)
+	{
+		return insert(value_type(value));
+	}
+
+	std::pair<iterator, bool> insert(value_type&& value)
+	{
+		auto it = lower_bound(value.first);
+
+		if (it != end() && !compare(value.first, it->first))
+		{
+			return {it, false};
+		}
+
+		return {values.insert(it, std::move(value)), true};
+	}
+
+	iterator insert(const_iterator hint, value_type&& value)
+	{
+		if (is_insert_position(hint, value.first))
+		{
+			return values.insert(hint, std::move(value));
+		}
+
+		return insert(std::move(value)).first;
+	}
+
+	iterator insert(const_iterator hint, const value_type& value)
+	{
+		return insert(hint, value_type(value));
+	}
+
+	template<typename ... Args>
+	std::pair<iterator, bool> try_emplace(const key_type& key, Args&& ... args)
+	{
+		return try_emplace_impl(key, std::forward<Args>(args)...);
+	}
+
+	template<typename ... Args>
+	std::pair<iterator, bool> try_emplace(key_type&& key, Args&& ... args)
+	{
+		return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+	}
+
+	template<
+		typename K,
+		typename ... Args,
+		typename = enable_if_transparent_t<K>,
+		typename = std::enable_if_t<!std::is_same_v<std::decay_t<K>, key_type>>>
+	std::pair<iterator, bool> try_emplace(K&& key, Args&& ... args)
+	{
+		return try_emplace_impl(std::forward<K>(key), std::forward<Args>(args)...);
+	}
+
+	iterator erase(const_iterator position)
+	{
+		return values.erase(position);
+	}
+
+	size_type erase(const key_type& key)
+	{
+		if (auto it = find(key); it != end())
+		{
+			values.erase(it);
+			return 1;
+		}
+
+		return 0;
+	}
+
+	bool operator==(const FlatMap& other) const
+	{
+		return values == other.values;
+	}
+
+	bool operator!=(const FlatMap& other) const
+	{
+		return values != other.values;
+	}
+
+private:
+	template<
+		typename Self,
+		typename K>
+	static auto& at_impl(Self& self, const K& key)
+	{
+		auto it = self.find(key);
+
+		if (it == self.end())
+		{
+			throw StructMappingException("FlatMap: key not found");
+		}
+
+		return it->second;
+	}
+
+	template<
+		typename Self,
+		typename K>
+	static auto find_impl(Self& self, const K& key)
+	{
+		auto it = self.lower_bound(key);
+
+		if (it != self.end() && !self.compare(key, it->first))
+		{
+			return it;
+		}
+
+		return self.end();
+	}
+
+	template<
+		typename Self,
+		typename K>
+	static auto lower_bound_impl(Self& self, const K& key)
+	{
+		return std::lower_bound(
+			self.begin(),
+			self.end(),
+			key,
+			[&self] (const value_type& value, const K& key_)
+			{
+				return self.compare(value.first, key_);
+			});
+	}
+
+	bool is_insert_position(const_iterator hint, const key_type& key) const
+	{
+		return (hint == cbegin() || compare(std::prev(hint)->first, key))
+			&& (hint == cend() || compare(key, hint->first));
+	}
+
+	template<
+		typename K,
+		typename ... Args>
+	std::pair<iterator, bool> try_emplace_impl(K&& key, Args&& ... args)
+	{
+		auto it = lower_bound(key);
+
+		if (it != end() && !compare(key, it->first))
+		{
+			return {it, false};
+		}
+
+		it = values.emplace(
+			it,
+			std::piecewise_construct,
+			std::forward_as_tuple(std::forward<K>(key)),
+			std::forward_as_tuple(std::forward<Args>(args)...));
+
+		return {it, true};
+	}
+
+private:
+	container_type values;
+	Compare compare;
+};
+
+} // struct_mapping
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "utility.h"
 
+#include <cstddef>
 #include <functional>
 #include <string>
 #include <vector>
@@ -17,8 +18,10 @@ class Functions
 public:
 	using CheckNotEmpty = void (T&, const std::string&);
 	using Init = void (T&);
+	using IsSkipped = bool (const std::string&);
 	using IterateOver = void (T&, const std::string&);
 	using Release = bool (T&);
+	using Reserve = void (T&, std::size_t);
 	using SetBool = void (T&, const std::string&, bool);
 	using SetDefault = void (T&, Index);
 	using SetFloatingPoint = void (T&, const std::string&, double);
@@ -42,6 +45,12 @@ public:
 				ObjectType<V, is_array_like_v<V>, is_map_like_v<V>>::init(o.*ptr);
 			});
 
+		is_skipped.emplace_back(
+			[] (const std::string& name_)
+			{
+				return ObjectType<V, is_array_like_v<V>, is_map_like_v<V>>::is_skipped(name_);
+			});
+
 		iterate_over.emplace_back(
 			[ptr] (T& o, const std::string& name_)
 			{
@@ -54,6 +63,15 @@ public:
 				return ObjectType<V, is_array_like_v<V>, is_map_like_v<V>>::release(o.*ptr);
 			});
 
+		reserve.emplace_back(
+			[ptr] (T& o, std::size_t capacity_)
+			{
+				if constexpr (has_reserve_v<V>)
+				{
+					(o.*ptr).reserve(capacity_);
+				}
+			});
+
 		set_bool.emplace_back(
 			[ptr] (T& o, const std::string& name_, bool value_)
 			{
@@ -96,8 +114,10 @@ public:
 public:
 	std::vector<std::function<CheckNotEmpty>> check_not_empty;
 	std::vector<std::function<Init>> init;
+	std::vector<std::function<IsSkipped>> is_skipped;
 	std::vector<std::function<IterateOver>> iterate_over;
 	std::vector<std::function<Release>> release;
+	std::vector<std::function<Reserve>> reserve;
 	std::vector<std::function<SetBool>> set_bool;
 	std::vector<std::function<SetDefault>> set_default;
 	std::vector<std::function<SetFloatingPoint>> set_floating_point;
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "hasher.h"
+#include "member_string.h"
+#include "object.h"
+#include "object_array_like.h"
+#include "object_map_like.h"
+#include "utility.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace struct_mapping
+{
+
+namespace detail
+{
+
+template<
+	typename,
+	typename = std::void_t<>>
+struct is_unordered : std::false_type{};
+
+template<typename T>
+struct is_unordered<T, std::void_t<typename T::hasher>> : std::true_type{};
+
+template<typename T>
+constexpr bool is_unordered_v = is_unordered<T>::value;
+
+template<typename V>
+void hash_value(Hasher& hasher, const V& value)
+{
+	if constexpr (is_optional_v<V>)
+	{
+		hasher.update_bool(value.has_value());
+
+		if (value)
+		{
+			hash_value(hasher, value.value());
+		}
+	}
+	else if constexpr (std::is_same_v<V, bool>)
+	{
+		hasher.update_bool(value);
+	}
+	else if constexpr (std::is_integral_v<V> || std::is_enum_v<V>)
+	{
+		hasher.update_integral(static_cast<long long>(value));
+	}
+	else if constexpr (std::is_floating_point_v<V>)
+	{
+		hasher.update_floating_point(static_cast<double>(value));
+	}
+	else if constexpr (std::is_same_v<V, std::string>)
+	{
+		hasher.update_string(value);
+	}
+	else if constexpr (is_unordered_v<V>)
+	{
+		// Iteration order is not part of the content: combine the element hashes commutatively
+		std::uint64_t sum = 0;
+
+		for (const auto& v : value)
+		{
+			Hasher element_hasher;
+
+			if constexpr (is_map_like_v<V>)
+			{
+				hash_value(element_hasher, v.first);
+				hash_value(element_hasher, v.second);
+			}
+			else
+			{
+				hash_value(element_hasher, v);
+			}
+
+			sum += element_hasher.digest();
+		}
+
+		hasher.update_integral(static_cast<long long>(value.size()));
+		hasher.update_hash(sum);
+	}
+	else if constexpr (is_map_like_v<V>)
+	{
+		hasher.update_integral(static_cast<long long>(value.size()));
+
+		for (const auto& [k, v] : value)
+		{
+			hash_value(hasher, k);
+			hash_value(hasher, v);
+		}
+	}
+	else if constexpr (is_array_like_v<V>)
+	{
+		hasher.update_integral(static_cast<long long>(value.size()));
+
+		for (const auto& v : value)
+		{
+			hash_value(hasher, v);
+		}
+	}
+	else
+	{
+		if (IsMemberStringExist<V>::value)
+		{
+			hasher.update_string(MemberString<V>::to_string()(value));
+		}
+		else
+		{
+			Object<V>::hash(value, hasher);
+		}
+	}
+}
+
+template<typename V>
+bool equal_value(const V& a, const V& b)
+{
+	if constexpr (is_optional_v<V>)
+	{
+		if (a.has_value() != b.has_value())
+		{
+			return false;
+		}
+
+		return !a.has_value() || equal_value(a.value(), b.value());
+	}
+	else if constexpr (is_integral_or_floating_point_or_string_v<V> || std::is_enum_v<V>)
+	{
+		return a == b;
+	}
+	else if constexpr (is_unordered_v<V>)
+	{
+		if (a.size() != b.size())
+		{
+			return false;
+		}
+
+		if constexpr (is_map_like_v<V>)
+		{
+			for (const auto& [k, v] : a)
+			{
+				const auto it = b.find(k);
+
+				if (it == b.end() || !equal_value(v, it->second))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+		else
+		{
+			return a == b;
+		}
+	}
+	else if constexpr (is_map_like_v<V> || is_array_like_v<V>)
+	{
+		if (a.size() != b.size())
+		{
+			return false;
+		}
+
+		auto it_b = b.begin();
+
+		for (auto it_a = a.begin(); it_a != a.end(); ++it_a, ++it_b)
+		{
+			if constexpr (is_map_like_v<V>)
+			{
+				if (!equal_value(it_a->first, it_b->first) || !equal_value(it_a->second, it_b->second))
+				{
+					return false;
+				}
+			}
+			else
+			{
+				if (!equal_value(*it_a, *it_b))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+	else
+	{
+		if (IsMemberStringExist<V>::value)
+		{
+			return MemberString<V>::to_string()(a) == MemberString<V>::to_string()(b);
+		}
+
+		return Object<V>::equal(a, b);
+	}
+}
+
+} // detail
+
+// Digest of a mapped value. To tell whether a reloaded document changed, map it and hash the
+// result (or each element of it): parsing alone does not produce these digests.
+template<typename T>
+inline std::uint64_t hash(const T& value, std::uint64_t seed = 0)
+{
+	Hasher hasher(seed);
+	detail::hash_value(hasher, value);
+
+	return hasher.digest();
+}
+
+template<typename T>
+inline bool equal(const T& a, const T& b)
+{
+	return detail::equal_value(a, b);
+}
+
+} // struct_mapping
\ No newline at end of file
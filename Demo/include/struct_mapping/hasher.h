@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+namespace struct_mapping
+{
+
+// Incremental 64-bit content hash. The result only depends on the sequence of values fed in,
+// not on the platform: integers are widened to 64 bits, strings are read byte by byte
+// and floating point zeros and NaNs are canonicalized.
+class Hasher
+{
+public:
+	explicit Hasher(std::uint64_t seed = 0)
+		:	state(seed ^ 0x9E3779B97F4A7C15ull) {}
+
+	void update_bool(bool value)
+	{
+		update_word(value ? 0x9Bull : 0x9Aull);
+	}
+
+	void update_integral(long long value)
+	{
+		update_word(static_cast<std::uint64_t>(value));
+	}
+
+	void update_floating_point(double value)
+	{
+		if (value == 0.0)
+		{
+			value = 0.0;
+		}
+		else if (std::isnan(value))
+		{
+			value = std::numeric_limits<double>::quiet_NaN();
+		}
+
+		std::uint64_t bits;
+		static_assert(sizeof(bits) == sizeof(value));
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		update_word(bits);
+	}
+
+	void update_string(std::string_view value)
+	{
+		const auto size = value.size();
+		std::size_t i = 0;
+
+		for (; i + 8 <= size; i += 8)
+		{
+			update_word(read_word(value.data() + i, 8));
+		}
+
+		if (i != size)
+		{
+			update_word(read_word(value.data() + i, size - i));
+		}
+
+		update_word(static_cast<std::uint64_t>(size));
+	}
+
+	void update_hash(std::uint64_t value)
+	{
+		update_word(value);
+	}
+
+	std::uint64_t digest() const
+	{
+		return mix(state ^ count);
+	}
+
+	static std::uint64_t of(std::string_view value)
+	{
+		Hasher hasher;
+		hasher.update_string(value);
+
+		return hasher.digest();
+	}
+
+private:
+	static std::uint64_t mix(std::uint64_t value)
+	{
+		value ^= value >> 33;
+		value *= 0xFF51AFD7ED558CCDull;
+		value ^= value >> 33;
+		value *= 0xC4CEB9FE1A85EC53ull;
+		value ^= value >> 33;
+
+		return value;
+	}
+
+	static std::uint64_t read_word(const char* data, std::size_t size)
+	{
+		std::uint64_t result = 0;
+
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			result |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (i * 8);
+		}
+
+		return result;
+	}
+
+	void update_word(std::uint64_t value)
+	{
+		state = (state ^ mix(value + count)) * 0x100000001B3ull;
+		state = (state << 31) | (state >> 33);
+		++count;
+	}
+
+private:
+	std::uint64_t state;
+	std::uint64_t count = 0;
+};
+
+} // struct_mapping
\ No newline at end of file
@@ -19,14 +19,22 @@ public:
 	using EndArray = void();
 
 public:
+	// Installed by each writer for the duration of one call, so they are per thread
 	template<typename T>
-	static inline std::function<Set<T>> set;
+	static inline thread_local std::function<Set<T>> set;
 	
-	static inline std::function<SetNull> set_null;
-	static inline std::function<StartStruct> start_struct;
-	static inline std::function<EndStruct> end_struct;
-	static inline std::function<StartArray> start_array;
-	static inline std::function<EndArray> end_array;
+	static inline thread_local std::function<SetNull> set_null;
+	static inline thread_local std::function<StartStruct> start_struct;
+	static inline thread_local std::function<EndStruct> end_struct;
+	static inline thread_local std::function<StartArray> start_array;
+	static inline thread_local std::function<EndArray> end_array;
+};
+
+// Position of the JSON writer installed in IterateOver
+struct JsonWriterState
+{
+	bool first_element = true;
+	unsigned indent_count = 0;
 };
 
 } // struct_mapping::detail
\ No newline at end of file
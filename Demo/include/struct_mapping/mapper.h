@@ -1,11 +1,14 @@
 #pragma once
 
 #include "debug.h"
+#include "diff.h"
+#include "element_hashes.h"
 #include "iterate_over.h"
 #include "object.h"
 #include "object_array_like.h"
 #include "object_map_like.h"
 #include "parser.h"
+#include "projection.h"
 #include "reset.h"
 #include "utility.h"
 
@@ -16,8 +19,13 @@
 namespace struct_mapping
 {
 
-template<typename T>
-inline void map_json_to_struct(T& result_struct, std::basic_istream<char>& json_data)
+namespace detail
+{
+
+template<
+	typename T,
+	typename IsSkipped>
+inline void map_json_to_struct_impl(T& result_struct, std::basic_istream<char>& json_data, IsSkipped is_skipped)
 {
 	detail::Reset::reset();
 
@@ -101,6 +109,7 @@ inline void map_json_to_struct(T& result_struct, std::basic_istream<char>& json_
 			std::cout << "struct_mapping: map_json_to_struct.end_struct:" << std::endl;
 		}
 
+		detail::ElementHashScope::set_element_level(struct_level == 2);
 		detail::Object<T>::release(result_struct);
 		--struct_level;
 	};
@@ -112,6 +121,11 @@ inline void map_json_to_struct(T& result_struct, std::basic_istream<char>& json_
 			std::cout << "struct_mapping: map_json_to_struct.start_array: " << name << std::endl;
 		}
 
+		if (struct_level == 1)
+		{
+			detail::ElementHashScope::start_array(name);
+		}
+
 		detail::Object<T>::use(result_struct, name);
 	};
 
@@ -122,6 +136,11 @@ inline void map_json_to_struct(T& result_struct, std::basic_istream<char>& json_
 			std::cout << "struct_mapping: map_json_to_struct.end_array:" << std::endl;
 		}
 
+		if (struct_level == 1)
+		{
+			detail::ElementHashScope::end_array();
+		}
+
 		detail::Object<T>::release(result_struct);
 	};
 
@@ -134,22 +153,54 @@ inline void map_json_to_struct(T& result_struct, std::basic_istream<char>& json_
 		start_struct,
 		end_struct,
 		start_array,
-		end_array);
+		end_array,
+		is_skipped);
 	
 	parser.parse(json_data);
 }
 
+} // detail
+
 template<typename T>
-inline void map_struct_to_json(
-	T& source_struct,
-	std::basic_ostream<char>& json_data,
-	std::string indent = "",
-	bool hide_null = true)
+inline void map_json_to_struct(T& result_struct, std::basic_istream<char>& json_data)
+{
+	detail::map_json_to_struct_impl(result_struct, json_data, [] (const std::string&) {return false;});
+}
+
+// Also fills element_hashes with the digest of every element of the struct's arrays of structs,
+// computed as each element is mapped. A digest equals hash() of the element.
+template<typename T>
+inline void map_json_to_struct(T& result_struct, std::basic_istream<char>& json_data, ElementHashes& element_hashes)
 {
-	bool first_element = true;
-	unsigned indent_count = 0;
+	detail::ElementHashScope element_hash_scope(element_hashes);
+
+	detail::map_json_to_struct_impl(result_struct, json_data, [] (const std::string&) {return false;});
+}
 
-	detail::IterateOver::set_null =	[&] (const std::string& name)
+template<typename T>
+inline void map_json_to_struct(T& result_struct, std::basic_istream<char>& json_data, const Projection& projection)
+{
+	detail::ProjectionScope projection_scope(projection);
+
+	detail::map_json_to_struct_impl(
+		result_struct,
+		json_data,
+		[] (const std::string& name)
+		{
+			return detail::Object<T>::is_skipped(name);
+		});
+}
+
+namespace detail
+{
+
+inline void set_json_writer(
+	std::basic_ostream<char>& json_data,
+	const std::string& indent,
+	bool hide_null,
+	JsonWriterState& state)
+{
+	IterateOver::set_null =	[&json_data, indent, hide_null, &state] (const std::string& name)
 		{
 			if constexpr (debug)
 			{
@@ -161,7 +212,7 @@ inline void map_struct_to_json(
 
 			if (!hide_null)
 			{
-				if (!first_element)
+				if (!state.first_element)
 				{
 					json_data << ",";
 				}
@@ -171,7 +222,7 @@ inline void map_struct_to_json(
 					json_data << "\n";
 				}
 
-				for (unsigned i = indent_count; i != 0; --i)
+				for (unsigned i = state.indent_count; i != 0; --i)
 				{
 					json_data << indent; 
 				}
@@ -193,10 +244,10 @@ inline void map_struct_to_json(
 				}
 			}
 
-			first_element = false;
+			state.first_element = false;
 		};
 
-	detail::IterateOver::set<bool> = [&] (const std::string& name, bool value)
+	IterateOver::set<bool> = [&json_data, indent, &state] (const std::string& name, bool value)
 		{
 			if constexpr (debug)
 			{
@@ -209,7 +260,7 @@ inline void map_struct_to_json(
 					<< std::endl;
 			}
 
-			if (!first_element)
+			if (!state.first_element)
 			{
 				json_data << ",";
 			}
@@ -219,7 +270,7 @@ inline void map_struct_to_json(
 				json_data << "\n";
 			}
 
-			for (unsigned i = indent_count; i != 0; --i)
+			for (unsigned i = state.indent_count; i != 0; --i)
 			{
 				json_data << indent; 
 			}
@@ -240,18 +291,18 @@ inline void map_struct_to_json(
 				json_data << std::boolalpha << value;
 			}
 
-			first_element = false;
+			state.first_element = false;
 		};
 
 
-	detail::IterateOver::set<long long> = [&] (const std::string& name, long long value)
+	IterateOver::set<long long> = [&json_data, indent, &state] (const std::string& name, long long value)
 		{
 			if constexpr (debug)
 			{
 				std::cout << "struct_mapping: map_struct_to_json.set<long long>: " << name << " : " << value << std::endl;
 			}
 
-			if (!first_element)
+			if (!state.first_element)
 			{
 				json_data << ",";
 			}
@@ -261,7 +312,7 @@ inline void map_struct_to_json(
 				json_data << "\n";
 			}
 
-			for (unsigned i = indent_count; i != 0; --i)
+			for (unsigned i = state.indent_count; i != 0; --i)
 			{
 				json_data << indent; 
 			}
@@ -282,17 +333,17 @@ inline void map_struct_to_json(
 				json_data << value;
 			}
 
-			first_element = false;
+			state.first_element = false;
 		};
 
-	detail::IterateOver::set<double> = [&] (const std::string& name, double value)
+	IterateOver::set<double> = [&json_data, indent, &state] (const std::string& name, double value)
 		{
 			if constexpr (debug)
 			{
 				std::cout << "struct_mapping: map_struct_to_json.set<double>: " << name << " : " << value << std::endl;
 			}
 
-			if (!first_element)
+			if (!state.first_element)
 			{
 				json_data << ",";
 			}
@@ -302,7 +353,7 @@ inline void map_struct_to_json(
 				json_data << "\n";
 			}
 
-			for (unsigned i = indent_count; i != 0; --i)
+			for (unsigned i = state.indent_count; i != 0; --i)
 			{
 				json_data << indent; 
 			}
@@ -323,10 +374,10 @@ inline void map_struct_to_json(
 				json_data << value;
 			}
 
-			first_element = false;
+			state.first_element = false;
 		};
 
-	detail::IterateOver::set<std::string> =	[&] (const std::string& name, std::string value)
+	IterateOver::set<std::string> =	[&json_data, indent, &state] (const std::string& name, std::string value)
 		{
 			if constexpr (debug)
 			{
@@ -338,7 +389,7 @@ inline void map_struct_to_json(
 					<< std::endl;
 			}
 
-			if (!first_element)
+			if (!state.first_element)
 			{
 				json_data << ",";
 			}
@@ -348,7 +399,7 @@ inline void map_struct_to_json(
 				json_data << "\n";
 			}
 
-			for (unsigned i = indent_count; i != 0; --i)
+			for (unsigned i = state.indent_count; i != 0; --i)
 			{
 				json_data << indent; 
 			}
@@ -369,22 +420,22 @@ inline void map_struct_to_json(
 				json_data << "\"" << value << "\"";
 			}
 
-			first_element = false;
+			state.first_element = false;
 		};
 
-	detail::IterateOver::start_struct =	[&] (const std::string& name)
+	IterateOver::start_struct =	[&json_data, indent, &state] (const std::string& name)
 		{
 			if constexpr (debug)
 			{
 				std::cout << "struct_mapping: map_struct_to_json.start_struct: " << name << std::endl;
 			}
 
-			if (!first_element)
+			if (!state.first_element)
 			{
 				json_data << ",";
 			}
 
-			if (indent_count != 0)
+			if (state.indent_count != 0)
 			{
 				if (!indent.empty())
 				{
@@ -392,12 +443,12 @@ inline void map_struct_to_json(
 				}
 			}
 
-			for (unsigned i = indent_count; i != 0; --i)
+			for (unsigned i = state.indent_count; i != 0; --i)
 			{
 				json_data << indent; 
 			}
 
-			first_element = true;
+			state.first_element = true;
 			if (name.empty())
 			{
 				json_data << "{";
@@ -414,40 +465,40 @@ inline void map_struct_to_json(
 				json_data << "{";
 			}
 
-			++indent_count;
+			++state.indent_count;
 		};
 
-	detail::IterateOver::end_struct =	[&] ()
+	IterateOver::end_struct =	[&json_data, indent, &state] ()
 		{
 			if constexpr (debug)
 			{
 				std::cout << "struct_mapping: map_struct_to_json.end_struct:" << std::endl;
 			}
 
-			--indent_count;
+			--state.indent_count;
 
 			if (!indent.empty())
 			{
 				json_data << "\n";
 			}
 
-			for (unsigned i = indent_count; i != 0; --i)
+			for (unsigned i = state.indent_count; i != 0; --i)
 			{
 				json_data << indent; 
 			}
 
 			json_data << "}";
-			first_element = false;
+			state.first_element = false;
 		};
 
-	detail::IterateOver::start_array = [&] (const std::string& name)
+	IterateOver::start_array = [&json_data, indent, &state] (const std::string& name)
 		{
 			if constexpr (debug)
 			{
 				std::cout << "struct_mapping: map_struct_to_json.start_array: " << name << std::endl;
 			}
 
-			if (!first_element)
+			if (!state.first_element)
 			{
 				json_data << ",";
 			}
@@ -457,12 +508,12 @@ inline void map_struct_to_json(
 				json_data << "\n";
 			}
 
-			for (unsigned i = indent_count; i != 0; --i)
+			for (unsigned i = state.indent_count; i != 0; --i)
 			{
 				json_data << indent; 
 			}
 
-			first_element = true;
+			state.first_element = true;
 			if (name.empty())
 			{
 				json_data << "[";
@@ -479,33 +530,65 @@ inline void map_struct_to_json(
 				json_data << "[";
 			}
 
-			++indent_count;
+			++state.indent_count;
 		};
 
-	detail::IterateOver::end_array = [&] ()
+	IterateOver::end_array = [&json_data, indent, &state] ()
 		{
 			if constexpr (debug)
 			{
 				std::cout << "struct_mapping: map_struct_to_json.end_array:" << std::endl;
 			}
 
-			--indent_count;
+			--state.indent_count;
 
 			if (!indent.empty())
 			{
 				json_data << "\n";
 			}
 
-			for (unsigned i = indent_count; i != 0; --i)
+			for (unsigned i = state.indent_count; i != 0; --i)
 			{
 				json_data << indent; 
 			}
 
 			json_data << "]";
-			first_element = false;
+			state.first_element = false;
 		};
+}
+
+} // detail
+
+template<typename T>
+inline void map_struct_to_json(
+	T& source_struct,
+	std::basic_ostream<char>& json_data,
+	std::string indent = "",
+	bool hide_null = true)
+{
+	detail::JsonWriterState state;
+	detail::set_json_writer(json_data, indent, hide_null, state);
 
 	detail::Object<T>::iterate_over(source_struct, "");
 }
 
+// Writes a JSON Patch (RFC 6902) that turns baseline_struct into current_struct, as an array of
+// operations any JSON Patch implementation can apply. Only changed members and array elements are
+// emitted, addressed by JSON Pointer paths such as "/elements/17/props/x". Array elements are
+// compared by index: elements past the end of the shorter array are added or removed.
+template<typename T>
+inline void map_struct_diff_to_json(
+	const T& baseline_struct,
+	const T& current_struct,
+	std::basic_ostream<char>& json_data,
+	std::string indent = "")
+{
+	detail::JsonWriterState state;
+	detail::set_json_writer(json_data, "", false, state);
+
+	std::string path;
+	detail::PatchWriter patch(json_data, indent, state);
+	detail::Object<T>::diff(baseline_struct, current_struct, path, patch);
+}
+
 } // struct_mapping
\ No newline at end of file
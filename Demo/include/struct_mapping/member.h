@@ -6,8 +6,10 @@
 #include "options/option_default.h"
 #include "options/option_not_empty.h"
 #include "options/option_required.h"
+#include "options/option_reserve.h"
 #include "utility.h"
 
+#include <cstddef>
 #include <functional>
 #include <string>
 #include <type_traits>
@@ -121,7 +123,7 @@ public:
 
 	void init()
 	{
-		changed = false;
+		ObjectType::set_member_changed(index, false);
 	}
 
 	void iterate_over(T& o)
@@ -199,20 +201,21 @@ public:
 		process_required();
 		process_default(o);
 		process_not_empty(o);
-		changed = false;
+		ObjectType::set_member_changed(index, false);
 	}
 
 public:
 	Index bounds_index = NO_INDEX;
-	bool changed = false;
 	Index default_index = NO_INDEX;
 	Index deep_index;
+	Index index = NO_INDEX;
 	bool is_optional;
 	Index member_string_index = NO_INDEX;
 	std::string name;
 	Index ptr_index;
 	bool option_not_empty = false;
 	bool option_required = false;
+	std::size_t reserve_capacity = 0;
 	Type type;
 
 private:
@@ -242,6 +245,11 @@ private:
 			op.template check_option<V>();
 			add_option_required<V>();
 		}
+		else if constexpr (std::is_same_v<Reserve<U>, std::decay_t<Op<U>>>)
+		{
+			op.template check_option<V>(name);
+			reserve_capacity = op.get_value();
+		}
 	}
 
 	template<
@@ -331,7 +339,7 @@ private:
 
 	void process_default(T& o)
 	{
-		if (!changed)
+		if (!ObjectType::member_changed(index))
 		{
 			switch (type)
 			{
@@ -403,7 +411,7 @@ private:
 	{
 		if (option_required)
 		{
-			Required<>::check_result(changed, name);
+			Required<>::check_result(ObjectType::member_changed(index), name);
 		}
 	}
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "enum_table.h"
 #include "exception.h"
 
 #include <functional>
@@ -34,24 +35,38 @@ public:
 		function_to_string = std::function<ToString>(function_to_string_);
 	}
 
-	static auto& from_string(const std::string& name = "")
+	static decltype(auto) from_string(const std::string& name = "")
 	{
-		if (!function_from_string)
+		if constexpr (detail::has_enum_names_v<T>)
 		{
-			throw StructMappingException("MemberString not set for member: " + name);
+			return detail::EnumFromString<T>(name);
 		}
+		else
+		{
+			if (!function_from_string)
+			{
+				throw StructMappingException("MemberString not set for member: " + name);
+			}
 
-		return function_from_string;
+			return (function_from_string);
+		}
 	}
 
-	static auto& to_string(const std::string& name = "")
+	static decltype(auto) to_string(const std::string& name = "")
 	{
-		if (!function_to_string)
+		if constexpr (detail::has_enum_names_v<T>)
 		{
-			throw StructMappingException("MemberString not set for member: " + name);
+			return detail::EnumToString<T>(name);
 		}
+		else
+		{
+			if (!function_to_string)
+			{
+				throw StructMappingException("MemberString not set for member: " + name);
+			}
 
-		return function_to_string;
+			return (function_to_string);
+		}
 	}
 
 private:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "functions.h"
+#include "hasher.h"
 #include "iterate_over.h"
 #include "member.h"
 #include "reset.h"
@@ -17,6 +18,17 @@
 namespace struct_mapping::detail
 {
 
+template<typename V>
+void hash_value(Hasher& hasher, const V& value);
+
+class PatchWriter;
+
+template<typename V>
+void diff_member(const V& baseline, const V& current, const std::string& name, std::string& path, PatchWriter& patch);
+
+template<typename V>
+bool equal_value(const V& a, const V& b);
+
 template<
 	typename T,
 	bool = is_array_like_v<T>,
@@ -43,10 +55,55 @@ public:
 
 			members_name_index.emplace(name, static_cast<Index>(members.size()));
 			MemberType member(name, ptr, std::forward<Options<U>>(options)...);
+			member.index = static_cast<Index>(members.size());
 
 			members.push_back(std::move(member));
 			members_ptr<V>.push_back(ptr);
+			members_index<V>.push_back(static_cast<Index>(members.size()) - 1);
+
+			members_hash.push_back(
+				[ptr, name_hash = Hasher::of(name)] (const T& o, Hasher& hasher)
+				{
+					hasher.update_hash(name_hash);
+					hash_value(hasher, o.*ptr);
+				});
+
+			members_diff.push_back(
+				[ptr, name] (const T& baseline, const T& current, std::string& path, PatchWriter& patch)
+				{
+					diff_member(baseline.*ptr, current.*ptr, name, path, patch);
+				});
+
+			members_equal.push_back(
+				[ptr] (const T& a, const T& b)
+				{
+					return equal_value(a.*ptr, b.*ptr);
+				});
+		}
+	}
+
+	template<typename V>
+	static Index member_index(MemberPtr<T, V> ptr)
+	{
+		for (Index i = 0; i < members_ptr<V>.size(); ++i)
+		{
+			if (members_ptr<V>[i] == ptr)
+			{
+				return members_index<V>[i];
+			}
 		}
+
+		return NO_INDEX;
+	}
+
+	static Index members_count()
+	{
+		return static_cast<Index>(members.size());
+	}
+
+	static void set_projection(const std::vector<bool>* projection_)
+	{
+		projection = projection_;
 	}
 
 	static void check_not_empty(T& o, const std::string& name)
@@ -60,6 +117,37 @@ public:
 		}
 	}
 
+	static void diff(const T& baseline, const T& current, std::string& path, PatchWriter& patch)
+	{
+		for (const auto& member_diff : members_diff)
+		{
+			member_diff(baseline, current, path, patch);
+		}
+	}
+
+	static bool equal(const T& a, const T& b)
+	{
+		for (const auto& member_equal : members_equal)
+		{
+			if (!member_equal(a, b))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static void hash(const T& o, Hasher& hasher)
+	{
+		for (const auto& member_hash : members_hash)
+		{
+			member_hash(o, hasher);
+		}
+
+		hasher.update_integral(static_cast<long long>(members_hash.size()));
+	}
+
 	static void init(T& o)
 	{
 		if constexpr (is_optional_v<T> && std::is_class_v<remove_optional_t<T>>)
@@ -76,6 +164,37 @@ public:
 		}
 	}
 
+	static bool is_skipped(const std::string& name)
+	{
+		if constexpr (is_optional_v<T> && std::is_class_v<remove_optional_t<T>>)
+		{
+			return Object<remove_optional_t<T>>::is_skipped(name);
+		}
+		else
+		{
+			if (member_deep_index == NO_INDEX)
+			{
+				if (projection == nullptr)
+				{
+					return false;
+				}
+
+				const auto member_name_index_it = members_name_index.find(name);
+
+				if (member_name_index_it == std::cend(members_name_index))
+				{
+					return false;
+				}
+
+				return !is_projected(member_name_index_it->second);
+			}
+			else
+			{
+				return functions.is_skipped[member_deep_index](name);
+			}
+		}
+	}
+
 	static void iterate_over(T& o, const std::string& name)
 	{
 		if constexpr (is_optional_v<T>)
@@ -111,9 +230,16 @@ public:
 		{
 			if (member_deep_index == NO_INDEX)
 			{
-				for (auto& member : members)
+				for (Index i = 0; i < members.size(); ++i)
 				{
-					member.release(o);
+					if (is_projected(i))
+					{
+						members[i].release(o);
+					}
+					else
+					{
+						members[i].init();
+					}
 				}
 
 				return true;
@@ -305,7 +431,7 @@ public:
 						|| (members[member_name_index].type == MemberType::Type::Complex
 							&& members[member_name_index].member_string_index != NO_INDEX))
 				{
-					members[member_name_index].changed = true;
+					set_member_changed(member_name_index, true);
 					member_string_from_string[members[member_name_index].member_string_index](o, value);
 				}
 				else if (members[member_name_index].type != MemberType::Type::String)
@@ -345,7 +471,13 @@ public:
 
 				member_deep_index = members[member_name_index].deep_index;
 				functions.init[member_deep_index](o);
-				members[member_name_index].changed = true;
+
+				if (members[member_name_index].reserve_capacity != 0)
+				{
+					functions.reserve[member_deep_index](o, members[member_name_index].reserve_capacity);
+				}
+
+				set_member_changed(member_name_index, true);
 			}
 			else
 			{
@@ -355,6 +487,11 @@ public:
 	}
 
 private:
+	static bool is_projected(Index index)
+	{
+		return projection == nullptr || (index < projection->size() && (*projection)[index]);
+	}
+
 	template<typename V>
 	static void reg_reset()
 	{
@@ -383,6 +520,21 @@ private:
 		member_deep_index = NO_INDEX;
 	}
 
+	static bool member_changed(Index index)
+	{
+		return index < members_changed.size() && members_changed[index];
+	}
+
+	static void set_member_changed(Index index, bool changed)
+	{
+		if (members_changed.size() < members.size())
+		{
+			members_changed.resize(members.size());
+		}
+
+		members_changed[index] = changed;
+	}
+
 	template<
 		typename U,
 		typename V>
@@ -417,7 +569,7 @@ private:
 			}
 		}
 
-		members[index].changed = true;
+		set_member_changed(index, true);
 
 		if (members[index].is_optional)
 		{
@@ -434,7 +586,10 @@ private:
 
 	static inline std::vector<std::function<void(T&, const std::string&)>> member_string_from_string{};
 	static inline std::vector<std::function<std::optional<std::string> (T&)>> member_string_to_string{};
-	static inline Index member_deep_index = NO_INDEX;
+	// Registration fills the tables below once and they are only read while mapping. The state
+	// of a mapping in progress is per thread, so different threads can map at the same time.
+	static inline thread_local Index member_deep_index = NO_INDEX;
+	static inline thread_local std::vector<bool> members_changed;
 	static inline std::vector<MemberType> members;
 	
 	template<typename V>
@@ -442,11 +597,20 @@ private:
 	
 	template<typename V>
 	static inline std::vector<V> members_default{};
+
+	static inline std::vector<std::function<void(const T&, const T&, std::string&, PatchWriter&)>> members_diff{};
+	static inline std::vector<std::function<bool(const T&, const T&)>> members_equal{};
+	static inline std::vector<std::function<void(const T&, Hasher&)>> members_hash{};
 	
+	template<typename V>
+	static inline std::vector<Index> members_index{};
+
 	static inline std::unordered_map<std::string, Index> members_name_index;
 	
 	template<typename V>
 	static inline std::vector<MemberPtr<T, V>> members_ptr{};
+
+	static inline thread_local const std::vector<bool>* projection = nullptr;
 };
 
 } // struct_mapping::detail
\ No newline at end of file
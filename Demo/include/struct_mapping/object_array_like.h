@@ -1,5 +1,6 @@
 #pragma once
 
+#include "element_hashes.h"
 #include "iterate_over.h"
 #include "member_string.h"
 #include "object.h"
@@ -31,6 +32,19 @@ public:
 
 	static void init(T&) {}
 
+	static bool is_skipped(const std::string& name)
+	{
+		if constexpr (is_complex_v<ValueType<T>>)
+		{
+			if (used)
+			{
+				return Object<ValueType<T>>::is_skipped(name);
+			}
+		}
+
+		return false;
+	}
+
 	static void iterate_over(T& o, const std::string& name)
 	{
 		IterateOver::start_array(name);
@@ -92,6 +106,7 @@ public:
 			{
 				if (Object<ValueType<T>>::release(get_last_inserted()))
 				{
+					ElementHashScope::element_done(get_last_inserted());
 					used = false;
 					if constexpr (has_key_type_v<T>)
 					{
@@ -299,8 +314,8 @@ private:
 	}
 
 private:
-	static inline LastInserted last_inserted;
-	static inline bool used = false;
+	static inline thread_local LastInserted last_inserted;
+	static inline thread_local bool used = false;
 };
 
 } // struct_mapping::detail
\ No newline at end of file
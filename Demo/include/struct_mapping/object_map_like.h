@@ -31,6 +31,19 @@ public:
 
 	static void init(T&) {}
 
+	static bool is_skipped(const std::string& name)
+	{
+		if constexpr (is_complex_v<ValueType<T>>)
+		{
+			if (used)
+			{
+				return Object<ValueType<T>>::is_skipped(name);
+			}
+		}
+
+		return false;
+	}
+
 	static void iterate_over(T& o, const std::string& name)
 	{
 		IterateOver::start_struct(name);
@@ -255,26 +268,32 @@ private:
 		return last_inserted->second;
 	}
 
+	// The parser hands every key over as a const std::string, so the key the map stores is
+	// still a copy of it: one allocation per new key beyond the small string buffer. try_emplace
+	// only saves the temporary pair and the work for duplicate keys.
 	template<typename V>
-	static Iterator insert(T& o, const std::string& name, const V& value)
+	static Iterator insert(T& o, const std::string& name, V&& value)
 	{
-		if constexpr (
+		if constexpr (has_try_emplace_v<T>)
+		{
+			return o.try_emplace(name, std::forward<V>(value)).first;
+		}
+		else if constexpr (
 			std::is_same_v<
 				decltype(std::declval<T>().insert(typename T::value_type())),
 				std::pair<Iterator, bool>>)
 		{
-			return o.insert(std::make_pair(name, value)).first;
+			return o.insert(std::make_pair(name, std::forward<V>(value))).first;
 		}
-		
-		if constexpr (std::is_same_v<decltype(std::declval<T>().insert(typename T::value_type())), Iterator>)
+		else if constexpr (std::is_same_v<decltype(std::declval<T>().insert(typename T::value_type())), Iterator>)
 		{
-			return o.insert(std::make_pair(name, value));
+			return o.insert(std::make_pair(name, std::forward<V>(value)));
 		}
 	}
 
 private:
-	static inline Iterator last_inserted;
-	static inline bool used = false;
+	static inline thread_local Iterator last_inserted;
+	static inline thread_local bool used = false;
 };
 
 } // struct_mapping::detail
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../utility.h"
+#include "../exception.h"
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+namespace struct_mapping
+{
+
+template<typename T>
+class Reserve
+{
+public:
+	Reserve(T capacity_)
+		:	capacity(capacity_) {}
+
+	template<typename M>
+	void check_option(const std::string& name) const
+	{
+		static_assert(
+			detail::is_integer_v<T>,
+			"bad option (Reserve): type error, expected integer");
+
+		static_assert(
+			!detail::is_optional_v<M> && detail::has_reserve_v<M>,
+			"bad option (Reserve): option can only be applied to containers with reserve()");
+
+		if constexpr (std::is_signed_v<T>)
+		{
+			if (capacity < 0)
+			{
+				throw StructMappingException(
+					"bad option (Reserve) for '" + name + "': capacity = " + std::to_string(capacity) + " is negative");
+			}
+		}
+	}
+
+	std::size_t get_value() const
+	{
+		return static_cast<std::size_t>(capacity);
+	}
+
+private:
+	T capacity;
+};
+
+} // struct_mapping
\ No newline at end of file
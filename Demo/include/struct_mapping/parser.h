@@ -17,7 +17,8 @@ template<
 	typename StartStruct,
 	typename EndStruct,
 	typename StartArray,
-	typename EndArray>
+	typename EndArray,
+	typename IsSkipped>
 class Parser
 {
 public:
@@ -33,7 +34,8 @@ public:
 		StartStruct start_struct_,
 		EndStruct end_struct_,
 		StartArray start_array_,
-		EndArray end_array_)
+		EndArray end_array_,
+		IsSkipped is_skipped_)
 		:	set_bool(set_bool_)
 		,	set_integral(set_integral_)
 		,	set_floating_point(set_floating_point_)
@@ -43,6 +45,7 @@ public:
 		,	end_struct(end_struct_)
 		,	start_array(start_array_)
 		,	end_array(end_array_)
+		,	is_skipped(is_skipped_)
 	{}
 
 	void parse(stream_type& data_)
@@ -210,6 +213,12 @@ private:
 
 		wait(":");
 
+		if (is_skipped(name))
+		{
+			skip_value();
+			return;
+		}
+
 		const char value_start_ch = wait("\"{[tf-0123456789n");
 
 		if (value_start_ch == '{')
@@ -300,6 +309,96 @@ private:
 		}
 	}
 
+	void skip_nested()
+	{
+		auto* buffer = data->rdbuf();
+		unsigned depth = 1;
+
+		for (auto ch = buffer->sbumpc(); ch != stream_type::traits_type::eof(); ch = buffer->sbumpc())
+		{
+			switch (ch)
+			{
+			case '\"':
+				skip_string();
+				break;
+			case '{':
+			case '[':
+				++depth;
+				break;
+			case '}':
+			case ']':
+				if (--depth == 0)
+				{
+					return;
+				}
+				break;
+			case '\n':
+				++line_number;
+				break;
+			default:
+				break;
+			}
+		}
+
+		throw StructMappingException("parser: unexpected end of data");
+	}
+
+	void skip_string()
+	{
+		auto* buffer = data->rdbuf();
+
+		for (auto ch = buffer->sbumpc(); ch != stream_type::traits_type::eof(); ch = buffer->sbumpc())
+		{
+			if (ch == '\\')
+			{
+				if (buffer->sbumpc() == stream_type::traits_type::eof())
+				{
+					break;
+				}
+			}
+			else if (ch == '\"')
+			{
+				return;
+			}
+		}
+
+		throw StructMappingException("parser: unexpected end of data");
+	}
+
+	void skip_value()
+	{
+		const char value_start_ch = wait("\"{[tf-0123456789n");
+
+		if (value_start_ch == '\"')
+		{
+			skip_string();
+		}
+		else if (value_start_ch == '{' || value_start_ch == '[')
+		{
+			skip_nested();
+		}
+		else
+		{
+			auto* buffer = data->rdbuf();
+
+			for (auto ch = buffer->sbumpc(); ch != stream_type::traits_type::eof(); ch = buffer->sbumpc())
+			{
+				if (ch == ',' || ch == '}' || ch == ']')
+				{
+					wait_char = static_cast<char>(ch);
+					return;
+				}
+
+				if (ch == '\n')
+				{
+					++line_number;
+				}
+			}
+
+			throw StructMappingException("parser: unexpected end of data");
+		}
+	}
+
 	char wait(char const* characters_)
 	{
 		char test_ch;
@@ -344,6 +443,7 @@ private:
 	EndStruct end_struct;
 	StartArray start_array;
 	EndArray end_array;
+	IsSkipped is_skipped;
 
 	stream_type* data;
 	size_t line_number = 1;
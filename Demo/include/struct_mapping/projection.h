@@ -0,0 +1,115 @@
+#pragma once
+
+#include "exception.h"
+#include "object.h"
+#include "utility.h"
+
+#include <string>
+#include <vector>
+
+namespace struct_mapping
+{
+
+namespace detail
+{
+
+class ProjectionScope;
+
+} // detail
+
+class Projection
+{
+	friend class detail::ProjectionScope;
+
+public:
+	template<typename ... Ptrs>
+	explicit Projection(Ptrs ... ptrs)
+	{
+		(add(ptrs), ...);
+	}
+
+	template<
+		typename T,
+		typename V>
+	Projection& add(detail::MemberPtr<T, V> ptr)
+	{
+		const auto index = detail::Object<T>::member_index(ptr);
+
+		if (index == detail::NO_INDEX)
+		{
+			throw StructMappingException("bad projection: member is not registered");
+		}
+
+		auto& mask = get_mask(&detail::Object<T>::set_projection, detail::Object<T>::members_count());
+		mask[index] = true;
+
+		return *this;
+	}
+
+private:
+	using SetProjection = void(*)(const std::vector<bool>*);
+
+	struct Entry
+	{
+		SetProjection set_projection;
+		std::vector<bool> mask;
+	};
+
+private:
+	std::vector<bool>& get_mask(SetProjection set_projection, detail::Index members_count)
+	{
+		for (auto& entry : entries)
+		{
+			if (entry.set_projection == set_projection)
+			{
+				if (entry.mask.size() < members_count)
+				{
+					entry.mask.resize(members_count, false);
+				}
+
+				return entry.mask;
+			}
+		}
+
+		entries.push_back(Entry{set_projection, std::vector<bool>(members_count, false)});
+
+		return entries.back().mask;
+	}
+
+private:
+	std::vector<Entry> entries;
+};
+
+namespace detail
+{
+
+class ProjectionScope
+{
+public:
+	explicit ProjectionScope(const Projection& projection_)
+		:	projection(projection_)
+	{
+		for (const auto& entry : projection.entries)
+		{
+			entry.set_projection(&entry.mask);
+		}
+	}
+
+	ProjectionScope(const ProjectionScope&) = delete;
+	ProjectionScope& operator=(const ProjectionScope&) = delete;
+
+	~ProjectionScope()
+	{
+		for (const auto& entry : projection.entries)
+		{
+			entry.set_projection(nullptr);
+		}
+	}
+
+private:
+	const Projection& projection;
+};
+
+} // detail
+
+} // struct_mapping
\ No newline at end of file
@@ -0,0 +1,539 @@
+#pragma once
+
+#include "exception.h"
+#include "mapper.h"
+#include "projection.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace struct_mapping
+{
+
+namespace detail
+{
+
+class ViewStreamBuf : public std::streambuf
+{
+public:
+	explicit ViewStreamBuf(std::string_view data)
+	{
+		auto begin = const_cast<char*>(data.data());
+		setg(begin, begin, begin + data.size());
+	}
+};
+
+class PointerScanner
+{
+public:
+	explicit PointerScanner(std::string_view data_)
+		:	data(data_) {}
+
+	std::optional<std::string_view> find(std::string_view pointer)
+	{
+		if (!pointer.empty() && pointer.front() != '/')
+		{
+			throw StructMappingException("json pointer: must be empty or start with '/': " + std::string(pointer));
+		}
+
+		position = 0;
+		skip_whitespace();
+
+		while (!pointer.empty())
+		{
+			pointer.remove_prefix(1);
+
+			const auto token_end = pointer.find('/');
+			const auto token = pointer.substr(0, token_end);
+			pointer.remove_prefix(token_end == std::string_view::npos ? pointer.size() : token_end);
+
+			const bool found = peek() == '{' ? enter_member(token) : (peek() == '[' ? enter_element(token) : false);
+
+			if (!found)
+			{
+				return std::nullopt;
+			}
+		}
+
+		const auto value_start = position;
+		skip_value();
+
+		return data.substr(value_start, position - value_start);
+	}
+
+	std::size_t size()
+	{
+		const char open_ch = next();
+
+		if (open_ch != '{' && open_ch != '[')
+		{
+			return 0;
+		}
+
+		const char close_ch = open_ch == '{' ? '}' : ']';
+		std::size_t result = 0;
+
+		skip_whitespace();
+		if (peek() == close_ch)
+		{
+			return 0;
+		}
+
+		for (;;)
+		{
+			if (open_ch == '{')
+			{
+				expect('\"');
+				skip_string();
+				skip_whitespace();
+				expect(':');
+				skip_whitespace();
+			}
+
+			skip_value();
+			++result;
+			skip_whitespace();
+
+			if (expect(open_ch == '{' ? ",}" : ",]") == close_ch)
+			{
+				return result;
+			}
+
+			skip_whitespace();
+		}
+	}
+
+private:
+	bool enter_element(std::string_view token)
+	{
+		std::size_t index = 0;
+
+		if (token.empty() || (token.size() > 1 && token.front() == '0'))
+		{
+			return false;
+		}
+
+		for (const char ch : token)
+		{
+			if (ch < '0' || ch > '9')
+			{
+				return false;
+			}
+
+			const auto digit = static_cast<std::size_t>(ch - '0');
+
+			// No array can be that long, the index would only wrap around
+			if (index > (std::numeric_limits<std::size_t>::max() - digit) / 10)
+			{
+				return false;
+			}
+
+			index = index * 10 + digit;
+		}
+
+		expect('[');
+		skip_whitespace();
+
+		if (peek() == ']')
+		{
+			return false;
+		}
+
+		for (;; --index)
+		{
+			if (index == 0)
+			{
+				return true;
+			}
+
+			skip_value();
+			skip_whitespace();
+
+			if (expect(",]") == ']')
+			{
+				return false;
+			}
+
+			skip_whitespace();
+		}
+	}
+
+	bool enter_member(std::string_view token)
+	{
+		expect('{');
+		skip_whitespace();
+
+		if (peek() == '}')
+		{
+			return false;
+		}
+
+		for (;;)
+		{
+			expect('\"');
+			const auto key_start = position;
+			skip_string();
+			const bool is_match = key_equals(data.substr(key_start, position - key_start - 1), token);
+
+			skip_whitespace();
+			expect(':');
+			skip_whitespace();
+
+			if (is_match)
+			{
+				return true;
+			}
+
+			skip_value();
+			skip_whitespace();
+
+			if (expect(",}") == '}')
+			{
+				return false;
+			}
+
+			skip_whitespace();
+		}
+	}
+
+	char expect(char ch)
+	{
+		if (next() != ch)
+		{
+			throw_unexpected();
+		}
+
+		return ch;
+	}
+
+	char expect(const char* characters)
+	{
+		const char ch = next();
+
+		for (; *characters; ++characters)
+		{
+			if (ch == *characters)
+			{
+				return ch;
+			}
+		}
+
+		throw_unexpected();
+	}
+
+	static bool key_equals(std::string_view key, std::string_view token)
+	{
+		if (key.find('\\') == std::string_view::npos && token.find('~') == std::string_view::npos)
+		{
+			return key == token;
+		}
+
+		return unescape_key(key) == unescape_token(token);
+	}
+
+	char next()
+	{
+		if (position >= data.size())
+		{
+			throw StructMappingException("json pointer: unexpected end of data");
+		}
+
+		return data[position++];
+	}
+
+	char peek() const
+	{
+		return position < data.size() ? data[position] : '\0';
+	}
+
+	void skip_nested()
+	{
+		unsigned depth = 1;
+
+		while (position < data.size())
+		{
+			switch (data[position++])
+			{
+			case '\"':
+				skip_string();
+				break;
+			case '{':
+			case '[':
+				++depth;
+				break;
+			case '}':
+			case ']':
+				if (--depth == 0)
+				{
+					return;
+				}
+				break;
+			default:
+				break;
+			}
+		}
+
+		throw StructMappingException("json pointer: unexpected end of data");
+	}
+
+	void skip_string()
+	{
+		while (position < data.size())
+		{
+			const char ch = data[position++];
+
+			if (ch == '\\')
+			{
+				++position;
+			}
+			else if (ch == '\"')
+			{
+				return;
+			}
+		}
+
+		throw StructMappingException("json pointer: unexpected end of data");
+	}
+
+	void skip_value()
+	{
+		const char ch = next();
+
+		if (ch == '\"')
+		{
+			skip_string();
+		}
+		else if (ch == '{' || ch == '[')
+		{
+			skip_nested();
+		}
+		else if (ch == 't' || ch == 'f' || ch == 'n' || ch == '-' || (ch >= '0' && ch <= '9'))
+		{
+			while (position < data.size()
+				&& data[position] != ','
+				&& data[position] != '}'
+				&& data[position] != ']'
+				&& !is_whitespace(data[position]))
+			{
+				++position;
+			}
+		}
+		else
+		{
+			--position;
+			throw_unexpected();
+		}
+	}
+
+	void skip_whitespace()
+	{
+		while (position < data.size() && is_whitespace(data[position]))
+		{
+			++position;
+		}
+	}
+
+	static bool is_whitespace(char ch)
+	{
+		return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+	}
+
+	[[noreturn]] void throw_unexpected() const
+	{
+		throw StructMappingException(
+			"json pointer: unexpected character '"
+				+ std::string(1, data[position - 1])
+				+ "' at offset "
+				+ std::to_string(position - 1));
+	}
+
+	static std::string unescape_key(std::string_view key)
+	{
+		std::string result;
+
+		for (std::size_t i = 0; i < key.size(); ++i)
+		{
+			if (key[i] != '\\' || i + 1 >= key.size())
+			{
+				result += key[i];
+				continue;
+			}
+
+			switch (const char escaped = key[++i]; escaped)
+			{
+			case 'b': result += '\b'; break;
+			case 'f': result += '\f'; break;
+			case 'n': result += '\n'; break;
+			case 'r': result += '\r'; break;
+			case 't': result += '\t'; break;
+			case 'u':
+			{
+				std::uint32_t code_point = read_hex4(key, i + 1);
+				i += 4;
+
+				// A high surrogate followed by an escaped low surrogate is one code point
+				if (code_point >= 0xD800 && code_point <= 0xDBFF
+					&& i + 6 < key.size() && key[i + 1] == '\\' && key[i + 2] == 'u')
+				{
+					const std::uint32_t low = read_hex4(key, i + 3);
+
+					if (low >= 0xDC00 && low <= 0xDFFF)
+					{
+						code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+						i += 6;
+					}
+				}
+
+				append_utf8(result, code_point);
+				break;
+			}
+			default: result += escaped; break;
+			}
+		}
+
+		return result;
+	}
+
+	static std::uint32_t read_hex4(std::string_view key, std::size_t start)
+	{
+		if (start + 4 > key.size())
+		{
+			throw StructMappingException("json pointer: bad unicode escape in key");
+		}
+
+		std::uint32_t value = 0;
+
+		for (std::size_t i = start; i < start + 4; ++i)
+		{
+			const char ch = key[i];
+			value <<= 4;
+
+			if (ch >= '0' && ch <= '9')
+			{
+				value |= static_cast<std::uint32_t>(ch - '0');
+			}
+			else if (ch >= 'a' && ch <= 'f')
+			{
+				value |= static_cast<std::uint32_t>(ch - 'a' + 10);
+			}
+			else if (ch >= 'A' && ch <= 'F')
+			{
+				value |= static_cast<std::uint32_t>(ch - 'A' + 10);
+			}
+			else
+			{
+				throw StructMappingException("json pointer: bad unicode escape in key");
+			}
+		}
+
+		return value;
+	}
+
+	static void append_utf8(std::string& result, std::uint32_t code_point)
+	{
+		if (code_point < 0x80)
+		{
+			result += static_cast<char>(code_point);
+		}
+		else if (code_point < 0x800)
+		{
+			result += static_cast<char>(0xC0 | (code_point >> 6));
+			result += static_cast<char>(0x80 | (code_point & 0x3F));
+		}
+		else if (code_point < 0x10000)
+		{
+			result += static_cast<char>(0xE0 | (code_point >> 12));
+			result += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+			result += static_cast<char>(0x80 | (code_point & 0x3F));
+		}
+		else
+		{
+			result += static_cast<char>(0xF0 | (code_point >> 18));
+			result += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+			result += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+			result += static_cast<char>(0x80 | (code_point & 0x3F));
+		}
+	}
+
+	static std::string unescape_token(std::string_view token)
+	{
+		std::string result;
+
+		for (std::size_t i = 0; i < token.size(); ++i)
+		{
+			if (token[i] == '~' && i + 1 < token.size() && (token[i + 1] == '0' || token[i + 1] == '1'))
+			{
+				result += token[++i] == '0' ? '~' : '/';
+			}
+			else
+			{
+				result += token[i];
+			}
+		}
+
+		return result;
+	}
+
+private:
+	std::string_view data;
+	std::size_t position = 0;
+};
+
+} // detail
+
+inline std::optional<std::string_view> find_json_pointer(std::string_view json_data, std::string_view pointer)
+{
+	return detail::PointerScanner(json_data).find(pointer);
+}
+
+inline std::optional<std::size_t> json_pointer_size(std::string_view json_data, std::string_view pointer)
+{
+	if (const auto value = find_json_pointer(json_data, pointer); value)
+	{
+		return detail::PointerScanner(value.value()).size();
+	}
+
+	return std::nullopt;
+}
+
+template<typename T>
+inline bool map_json_pointer_to_struct(T& result_struct, std::string_view json_data, std::string_view pointer)
+{
+	if (const auto value = find_json_pointer(json_data, pointer); value)
+	{
+		detail::ViewStreamBuf buffer(value.value());
+		std::istream stream(&buffer);
+
+		map_json_to_struct(result_struct, stream);
+		return true;
+	}
+
+	return false;
+}
+
+template<typename T>
+inline bool map_json_pointer_to_struct(
+	T& result_struct,
+	std::string_view json_data,
+	std::string_view pointer,
+	const Projection& projection)
+{
+	if (const auto value = find_json_pointer(json_data, pointer); value)
+	{
+		detail::ViewStreamBuf buffer(value.value());
+		std::istream stream(&buffer);
+
+		map_json_to_struct(result_struct, stream, projection);
+		return true;
+	}
+
+	return false;
+}
+
+} // struct_mapping
\ No newline at end of file
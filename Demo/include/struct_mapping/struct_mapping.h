@@ -1,13 +1,22 @@
 #pragma once
 
+#include "diff.h"
+#include "element_hashes.h"
+#include "enum_table.h"
 #include "exception.h"
+#include "flat_map.h"
+#include "hash.h"
+#include "hasher.h"
 #include "object.h"
 #include "member_string.h"
 #include "mapper.h"
+#include "projection.h"
+#include "query.h"
 #include "options/option_bounds.h"
 #include "options/option_default.h"
 #include "options/option_not_empty.h"
 #include "options/option_required.h"
+#include "options/option_reserve.h"
 
 #include <string>
 #include <utility>
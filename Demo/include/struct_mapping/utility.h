@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <limits>
 #include <optional>
 #include <string>
@@ -75,6 +76,35 @@ template<typename T>
 constexpr bool has_key_type_v = has_key_type<T>::value;
 
 
+template<
+	typename,
+	typename = std::void_t<>>
+struct has_reserve : std::false_type{};
+
+template<typename T>
+struct has_reserve<T, std::void_t<decltype(std::declval<T&>().reserve(std::size_t{}))>> : std::true_type{};
+
+template<typename T>
+constexpr bool has_reserve_v = has_reserve<T>::value;
+
+
+template<
+	typename,
+	typename = std::void_t<>>
+struct has_try_emplace : std::false_type{};
+
+template<typename T>
+struct has_try_emplace<
+	T,
+	std::void_t<
+		decltype(std::declval<T&>().try_emplace(
+			std::declval<const typename T::key_type&>(),
+			std::declval<typename T::mapped_type>()))>> : std::true_type{};
+
+template<typename T>
+constexpr bool has_try_emplace_v = has_try_emplace<T>::value;
+
+
 template<
 	typename,
 	typename = std::void_t<>>
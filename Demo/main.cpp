@@ -6,8 +6,12 @@
  */
 
 #include "pch.h"
-#include "fonts.h"
-#include "include/struct_mapping/struct_mapping.h"
+#include "scene/damage_tracker.h"
+#include "scene/rect_layer.h"
+#include "scene/redraw_scheduler.h"
+#include "scene/resolution_scaler.h"
+#include "scene/scene_loader.h"
+#include "scene/sprite_atlas.h"
 
 #define S1(x) #x
 #define S2(x) S1(x)
@@ -25,7 +29,7 @@ extern "C"
  /*
   * This application is a simple example of how to combine SDL and Skia it demonstrates:
   *   how to setup gpu rendering to the main window
-  *   how to perform cpu-side rendering and draw the result to the gpu-backed screen
+  *   how to pre-render sprites offscreen into an atlas and draw them with drawAtlas
   *   draw simple primitives (rectangles)
   *   draw more complex primitives (star)
   */
@@ -36,6 +40,9 @@ static const int kMsaaSampleCount = 0; //4;
 // // Skia needs 8 stencil bits
 static const int kStencilBits = 8;
 
+// How long the native loop blocks waiting for events when there is nothing to draw
+static const int kIdleWaitMs = 250;
+
 class SdlApp
 {
 public:
@@ -50,39 +57,6 @@ protected:
 	int viewHeight = 0;
 };
 
-struct Gradient {
-	std::list<std::string> colors;
-	std::list<std::string> offsets;
-	int angle;
-	std::string direction;
-	std::string type;
-};
-
-struct Properties {
-	int x;
-	int y;
-	int width;
-	int height;
-};
-
-struct Shape {
-	std::string type;
-	Properties props;
-	std::string value;
-	int fontSize;
-	std::string fillColor;
-	std::string strokeColor;
-	int strokeWidth;
-	Gradient gradient;
-	int letterSpacing;
-	std::string fontFamily;
-	std::string fontWeight;
-};
-
-struct Elements {
-	std::list <Shape> elements;
-};
-
 class SkiaApp : public SdlApp {
 public:
 	SkiaApp();
@@ -91,36 +65,62 @@ public:
 	void run();
 	void update();
 	void initializeData();
-	void drawExperiments(SkCanvas* canvas);
+	void drawFrame(SkCanvas* canvas);
+	void drawOverlay(SkCanvas* canvas);
 
 	static void update_callback(void* app);
+	static int event_watch(void* app, SDL_Event* event);
+	static void scene_published(void* app);
 
 	
 
 private:
 	void handle_events();
-
-	// Storage for the user created rectangles. The last one may still be being edited.
-	SkTArray<SkRect> fRects = {};
+	void handle_event(const SDL_Event& event);
+	bool needsFrame() const;
+	SkRect starDeviceBounds() const;
+	void makeWindowSurface();
+	void resizeWindow();
+	void resizeLayer();
+
+	// The user created rectangle that is still being edited, and its color
+	SkRect fDragRect = SkRect::MakeEmpty();
+	SkColor fDragColor = SK_ColorTRANSPARENT;
+	bool fDragging = false;
+	SkRandom rectColors;
+	// Finished rectangles, baked into cached tiles as they accumulate
+	RectLayer rectLayer;
 
 	sk_sp<GrDirectContext> grContext;
 	sk_sp<SkSurface> surface;
-	sk_sp<SkSurface> cpuSurface;
-
-	sk_sp<SkImage> image;
-  sk_sp<SkTypeface> typeface;
+	// Format of the window frame buffer, kept to wrap it again when the window is resized
+	GrGLFramebufferInfo framebufferInfo;
+	SkColorType colorType = kUnknown_SkColorType;
+	// Retained copy of the frame. The window back buffer is undefined after a swap, so frames
+	// only redraw the damaged parts of this layer and then present it whole.
+	sk_sp<SkSurface> layer;
+	// The layer is rendered at a lower resolution while frames take longer than the budget
+	// and stretched over the window when it is presented
+	ResolutionScaler scaler;
+	DamageTracker damage;
+	// Frames are only rendered while something is damaged, animating or requested
+	RedrawScheduler scheduler;
+	int starAnimation = 0;
+
+	// Offscreen rendered sprites, each only as large as its content
+	SpriteAtlas sprites;
+	int starSprite = -1;
 
 	SkPaint paint;
-	SkFont font;
 	float rotation = 0;
+	// Bounds of the star path, before it is rotated into place
+	SkRect starBounds = SkRect::MakeEmpty();
 
 	bool fQuit = false;
 
-	// Json processing data
-	Elements elements;
+	// The JSON scene, built on a loader thread and drawn under the interactive parts of the frame
+	SceneLoader scene{SkRect::MakeIWH(viewWidth, viewHeight)};
 	std::string jsonFileName = "assets/sample_json.json";
-	std::string LBL_RECTANGLE= std::string("RECTANGLE");
-	std::string LBL_TEXT= std::string("TEXT");
 };
 
 static void throw_sdl_error() {
@@ -237,70 +237,185 @@ void SkiaApp::run()
 {
 	while (!fQuit)
 	{
+		if (!needsFrame()) {
+			// Idle: block until input arrives instead of spinning
+			scheduler.sleep();
+			SDL_Event event;
+			if (SDL_WaitEventTimeout(&event, kIdleWaitMs)) {
+				handle_event(event);
+			}
+			scheduler.wake();
+			continue;
+		}
 		update();
 	}
 }
 
-void SkiaApp::update()
+bool SkiaApp::needsFrame() const
 {
-	auto* canvas = surface->getCanvas();
-	const char* helpMessage = "Click and drag to create rects.  Press esc to quit.";
+	return scheduler.hasPendingFrame() || !damage.isEmpty() || scene.hasUpdate();
+}
 
-	canvas->clear(SK_ColorWHITE);
+void SkiaApp::update()
+{
 	handle_events();
 
+	// A scene finished on the loader thread replaces the old one between two frames
+	if (scene.update()) {
+		damage.invalidateAll();
+	}
 
-	// draw experiments
-	drawExperiments(canvas);
+	// The star turns by a degree every frame while its animation runs
+	if (scheduler.isAnimationRunning(starAnimation)) {
+		damage.add(starDeviceBounds());
+		rotation++;
+		damage.add(starDeviceBounds());
+	}
 
-	paint.setColor(SK_ColorBLACK);
-	canvas->drawString(helpMessage, 100.0f, 100.0f, font, paint);
+	scheduler.frameDone();
+	if (damage.isEmpty() && scaler.scale() < 1 && !needsFrame()) {
+		// Nothing moves anymore, leave a full resolution frame on screen
+		scaler.reset();
+		resizeLayer();
+	}
+	if (damage.isEmpty()) {
+#ifdef SK_BUILD_FOR_WASM
+		// Stop getting animation frames until an event or animation wakes the scheduler
+		if (!needsFrame()) {
+			scheduler.sleep();
+			emscripten_pause_main_loop();
+		}
+#endif
+		return;
+	}
 
-	SkRandom rand;
-	for (int i = 0; i < fRects.count(); i++) {
-		paint.setColor(rand.nextU() | 0x44808080);
-		canvas->drawRect(fRects[i], paint);
+	const Uint64 frameStart = SDL_GetPerformanceCounter();
+	const float scale = scaler.scale();
+
+	auto* layerCanvas = layer->getCanvas();
+	for (const SkIRect& rect : damage.rects()) {
+		layerCanvas->save();
+		// Damage is tracked in window pixels, the layer has only scale as many per side
+		SkIRect layerRect = SkMatrix::Scale(scale, scale).mapRect(SkRect::Make(rect)).roundOut();
+		layerCanvas->clipRect(SkRect::Make(layerRect));
+		layerCanvas->scale(scale, scale);
+		drawFrame(layerCanvas);
+		layerCanvas->restore();
 	}
+	damage.reset();
 
-	// draw offscreen canvas
-	canvas->save();
-	canvas->translate(float(viewWidth) / 2, float(viewHeight) / 2);
-	canvas->rotate(rotation++);
-	canvas->drawImage(image, -50.0f, -50.0f);
-	canvas->restore();
+	auto* canvas = surface->getCanvas();
+	SkPaint presentPaint;
+	presentPaint.setBlendMode(SkBlendMode::kSrc);
+	// The snapshot is a temporary, released before the next frame draws into the layer,
+	// so the layer is never copied on write
+	if (scale == 1) {
+		canvas->drawImage(layer->makeImageSnapshot(), 0, 0, &presentPaint);
+	} else {
+		presentPaint.setFilterQuality(kLow_SkFilterQuality);
+		canvas->drawImageRect(layer->makeImageSnapshot(), SkRect::MakeWH(viewWidth * scale, viewHeight * scale),
+			SkRect::MakeIWH(viewWidth, viewHeight), &presentPaint, SkCanvas::kStrict_SrcRectConstraint);
+	}
+	if (scaler.options().fullResolutionText) {
+		drawOverlay(canvas);
+	}
 
 	canvas->flush();
+	// Swapping waits for vsync, only the time spent rendering counts against the budget
+	double frameMs = 1000.0 * (SDL_GetPerformanceCounter() - frameStart) / SDL_GetPerformanceFrequency();
+	if (scaler.addFrame(frameMs)) {
+		printf("EMSC:: Rendering at %.0f%% resolution, last frames took %.1f ms\n", scaler.scale() * 100, frameMs);
+		resizeLayer();
+	}
 	SDL_GL_SwapWindow(window);
 }
 
-void SkiaApp::drawExperiments(SkCanvas* canvas) {
-	canvas->save();
-	
-	canvas->translate(SkIntToScalar(128), SkIntToScalar(128));
-	SkRect rect = SkRect::MakeXYWH(-90.5f, -90.5f, 181.0f, 181.0f);
-	SkPaint paint;
-	paint.setColor(SK_ColorBLUE);
-	canvas->drawRect(rect, paint);
-
-	SkPath path;
-	path.cubicTo(768, 0, -512, 256, 256, 256);
-	paint.setColor(SK_ColorGREEN);
-	canvas->drawPath(path, paint);
-
-	// rendering data from file
-	std::list <Shape> shapes = elements.elements;
-	for (Shape shape : shapes) {
-		if (LBL_RECTANGLE.compare(shape.type) == 0) {
-			SkRect rectFromFile = SkRect::MakeXYWH(shape.props.x, shape.props.y, shape.props.width, shape.props.height);
-			paint.setColor(SK_ColorYELLOW);
-			canvas->drawRect(rectFromFile, paint);
-		}else if (LBL_TEXT.compare(shape.type) == 0) {
-			paint.setColor(SK_ColorBLACK);
-			canvas->drawString(shape.value.c_str(), shape.props.x, shape.props.y, font, paint);
-		}
+// Wraps the window frame buffer, at the current view size, in a Skia surface
+void SkiaApp::makeWindowSurface()
+{
+	GrBackendRenderTarget target(viewWidth, viewHeight, kMsaaSampleCount, kStencilBits, framebufferInfo);
+
+	// To use distance field text, use commented out SkSurfaceProps instead
+	// SkSurfaceProps props(SkSurfaceProps::kUseDeviceIndependentFonts_Flag,
+	// 	SkSurfaceProps::kLegacyFontHost_InitType);
+	SkSurfaceProps props(SkSurfaceProps::kLegacyFontHost_InitType);
+	surface = SkSurface::MakeFromBackendRenderTarget(grContext.get(), target,
+		kBottomLeft_GrSurfaceOrigin,
+		colorType, nullptr, &props);
+	assert(surface);
+}
+
+// The drawable may have a new size: everything sized to the window is made again for it,
+// and the scene is recorded over the new bounds on the loader thread
+void SkiaApp::resizeWindow()
+{
+	int width = 0;
+	int height = 0;
+	SDL_GL_GetDrawableSize(window, &width, &height);
+	if (width <= 0 || height <= 0) {
+		// Minimized, nothing to draw into until the window comes back
+		return;
+	}
+	if (width != viewWidth || height != viewHeight) {
+		viewWidth = width;
+		viewHeight = height;
+		printf("EMSC:: View resized to %d x %d\n", viewWidth, viewHeight);
+		glViewport(0, 0, viewWidth, viewHeight);
+		makeWindowSurface();
+		damage.setSurfaceSize(viewWidth, viewHeight);
+		resizeLayer();
+		scene.setBounds(SkRect::MakeIWH(viewWidth, viewHeight));
+	}
+	damage.invalidateAll();
+	scheduler.requestFrame();
+}
+
+// A layer of the current render scale, completely damaged
+void SkiaApp::resizeLayer()
+{
+	const float scale = scaler.scale();
+	SkImageInfo info = surface->imageInfo().makeWH(static_cast<int>(std::ceil(viewWidth * scale)),
+		static_cast<int>(std::ceil(viewHeight * scale)));
+	layer = SkSurface::MakeRenderTarget(grContext.get(), SkBudgeted::kNo, info);
+	assert(layer);
+	damage.invalidateAll();
+}
+
+// Draws everything inside the canvas clip; the clip is what keeps partial redraws cheap
+void SkiaApp::drawFrame(SkCanvas* canvas)
+{
+	scene.draw(canvas);
+
+	if (!scaler.options().fullResolutionText) {
+		drawOverlay(canvas);
+	}
+
+	rectLayer.draw(canvas);
+	if (fDragging) {
+		paint.setColor(fDragColor);
+		canvas->drawRect(fDragRect, paint);
 	}
 
-	canvas->restore();
+	// draw the star sprite, rotated about the center of the view
+	sprites.draw(canvas, starSprite, SkRSXform::MakeFromRadians(1, SkDegreesToRadians(rotation),
+		float(viewWidth) / 2, float(viewHeight) / 2, 0, 0));
+}
+
+// Text drawn over the scene, in window pixels
+void SkiaApp::drawOverlay(SkCanvas* canvas)
+{
+	const char* helpMessage = "Click and drag to create rects.  Space toggles the star.  Press esc to quit.";
+
+	paint.setColor(SK_ColorBLACK);
+	canvas->drawString(helpMessage, 100.0f, 100.0f, scene.font(), paint);
+}
+
+SkRect SkiaApp::starDeviceBounds() const
+{
+	SkMatrix matrix;
+	matrix.setRotate(rotation);
+	matrix.postTranslate(float(viewWidth) / 2, float(viewHeight) / 2);
+	return matrix.mapRect(starBounds).makeOutset(2, 2);
 }
 
 void SkiaApp::update_callback(void* app)
@@ -308,38 +423,96 @@ void SkiaApp::update_callback(void* app)
 	static_cast<SkiaApp*>(app)->update();
 }
 
+// Runs inside SDL_PushEvent, which in WASM is called from the browser event handlers
+int SkiaApp::event_watch(void* app, SDL_Event*)
+{
+	static_cast<SkiaApp*>(app)->scheduler.wake();
+	return 0;
+}
+
+// Runs on the loader thread
+void SkiaApp::scene_published(void* app)
+{
+#ifdef SK_BUILD_FOR_WASM
+	// The main loop can only be resumed from the browser thread
+	emscripten_async_run_in_main_runtime_thread(EM_FUNC_SIG_VI, reinterpret_cast<void*>(+[](void* target) {
+		static_cast<SkiaApp*>(target)->scheduler.wake();
+	}), app);
+#else
+	// Wakes the native loop out of SDL_WaitEventTimeout, the event itself is ignored
+	SDL_Event event = {};
+	event.type = SDL_USEREVENT;
+	SDL_PushEvent(&event);
+#endif
+}
+
 void SkiaApp::handle_events() {
 	SDL_Event event;
 	while (SDL_PollEvent(&event)) {
-		switch (event.type) {
-		case SDL_MOUSEMOTION:
-			if (event.motion.state == SDL_PRESSED) {
-				SkRect& rect = fRects.back();
-				rect.fRight = static_cast<SkScalar>(event.motion.x);
-				rect.fBottom = static_cast<SkScalar>(event.motion.y);
-			}
-			break;
-		case SDL_MOUSEBUTTONDOWN:
-			if (event.button.state == SDL_PRESSED) {
-				fRects.push_back() = SkRect::MakeLTRB(SkIntToScalar(event.button.x),
-					SkIntToScalar(event.button.y),
-					SkIntToScalar(event.button.x),
-					SkIntToScalar(event.button.y));
-			}
-			break;
-		case SDL_KEYDOWN: {
-			SDL_Keycode key = event.key.keysym.sym;
-			if (key == SDLK_ESCAPE) {
-				fQuit = true;
-			}
-			break;
+		handle_event(event);
+	}
+}
+
+void SkiaApp::handle_event(const SDL_Event& event) {
+	switch (event.type) {
+	case SDL_MOUSEMOTION:
+		if (fDragging && event.motion.state == SDL_PRESSED) {
+			SkRect oldBounds = fDragRect.makeSorted().makeOutset(1, 1);
+			fDragRect.fRight = static_cast<SkScalar>(event.motion.x);
+			fDragRect.fBottom = static_cast<SkScalar>(event.motion.y);
+			damage.addMove(oldBounds, fDragRect.makeSorted().makeOutset(1, 1));
+		}
+		break;
+	case SDL_MOUSEBUTTONDOWN:
+		if (event.button.state == SDL_PRESSED) {
+			fDragRect = SkRect::MakeLTRB(SkIntToScalar(event.button.x),
+				SkIntToScalar(event.button.y),
+				SkIntToScalar(event.button.x),
+				SkIntToScalar(event.button.y));
+			fDragColor = rectColors.nextU() | 0x44808080;
+			fDragging = true;
 		}
-		case SDL_QUIT:
+		break;
+	case SDL_MOUSEBUTTONUP:
+		if (fDragging) {
+			// Hand the finished rectangle over to the layer
+			rectLayer.add(fDragRect, fDragColor);
+			damage.add(fDragRect.makeSorted().makeOutset(1, 1));
+			fDragging = false;
+		}
+		break;
+	case SDL_KEYDOWN: {
+		SDL_Keycode key = event.key.keysym.sym;
+		if (key == SDLK_ESCAPE) {
 			fQuit = true;
+		}
+		else if (key == SDLK_SPACE) {
+			scheduler.setAnimationRunning(starAnimation, !scheduler.isAnimationRunning(starAnimation));
+		}
+		break;
+	}
+	case SDL_WINDOWEVENT:
+		switch (event.window.event) {
+		case SDL_WINDOWEVENT_EXPOSED:
+		case SDL_WINDOWEVENT_SHOWN:
+		case SDL_WINDOWEVENT_RESTORED:
+		case SDL_WINDOWEVENT_MAXIMIZED:
+			// The window contents may be gone, repaint them even while the loop is idle
+			damage.invalidateAll();
+			scheduler.requestFrame();
+			break;
+		case SDL_WINDOWEVENT_SIZE_CHANGED:
+			resizeWindow();
 			break;
 		default:
 			break;
 		}
+		break;
+	case SDL_QUIT:
+		fQuit = true;
+		break;
+	default:
+		break;
 	}
 }
 
@@ -433,49 +606,15 @@ void SkiaApp::initializeData() {
 		jsonDataFromFile = json_data.str();
 	}
 
-	// Mapping JSON root
-	printf("EMSC:: Mapping Json properties to Cpp structs\n");
-	struct_mapping::reg(&Elements::elements, "elements");
-	// Mapping Shapes properties
-	printf("EMSC:: Mapping Shapes properties\n");
-	struct_mapping::reg(&Shape::type, "type");
-	struct_mapping::reg(&Shape::value, "value");
-	struct_mapping::reg(&Shape::fontSize, "fontSize");
-	struct_mapping::reg(&Shape::fillColor, "fillColor");
-	struct_mapping::reg(&Shape::strokeColor, "strokeColor");
-	struct_mapping::reg(&Shape::strokeWidth, "strokeWidth");
-	struct_mapping::reg(&Shape::letterSpacing, "letterSpacing");
-	struct_mapping::reg(&Shape::fontFamily, "fontFamily");
-	struct_mapping::reg(&Shape::fontWeight, "fontWeight");
-	// Mapping objects in Shape struct
-	struct_mapping::reg(&Shape::props, "props");
-	struct_mapping::reg(&Shape::gradient, "gradient");
-
-	// Mapping Properties properties
-	printf("EMSC:: Mapping Properties properties\n");
-	struct_mapping::reg(&Properties::x, "x");
-	struct_mapping::reg(&Properties::y, "y");
-	struct_mapping::reg(&Properties::width, "width");
-	struct_mapping::reg(&Properties::height, "height");
-
-	// Mapping Gradient properties
-	printf("EMSC:: Mapping Gradient properties\n");
-	struct_mapping::reg(&Gradient::angle, "angle");
-	struct_mapping::reg(&Gradient::direction, "direction");
-	struct_mapping::reg(&Gradient::type, "type");
-	// Mapping collections in Gradient struct
-	struct_mapping::reg(&Gradient::colors, "colors");
-	struct_mapping::reg(&Gradient::offsets, "offsets");
-
-	printf("EMSC:: parsing json data struct\n");
-	std::istringstream streamjsonDataFromFile(jsonDataFromFile);
-	struct_mapping::map_json_to_struct(elements, streamjsonDataFromFile);
-	printf("EMSC:: parsing json data struct finished\n");
-	printf("EMSC:: Reading data from json - elements size is %lu\n", elements.elements.size());
+	// Mapping and compiling happen on the loader thread, frames are drawn meanwhile
+	printf("EMSC:: Queueing Json mapping on the scene loader thread\n");
+	scene.load(std::move(jsonDataFromFile));
 	printf("EMSC:: Data initialization completed\n");
 }
+
 SkiaApp::SkiaApp()
 {
+	scene.setPublishCallback([this] { scene_published(this); });
 	initializeData();
 	printf("EMSC:: Setting viewport\n");
   glViewport(0, 0, viewWidth, viewHeight);
@@ -498,14 +637,12 @@ SkiaApp::SkiaApp()
 	printf("EMSC:: Wrapping up the frame buffer object attached to the screen in a Skia render target so Skia can render to it\n");
 	GrGLint buffer;
 	GR_GL_GetIntegerv(interface.get(), GR_GL_FRAMEBUFFER_BINDING, &buffer);
-	GrGLFramebufferInfo info;
+	GrGLFramebufferInfo& info = framebufferInfo;
 	info.fFBOID = (GrGLuint)buffer;
 
 	int contextType;
 	SDL_GL_GetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, &contextType);
 
-  SkColorType colorType;
-
 #ifdef SK_BUILD_FOR_WASM
     info.fFormat = GL_RGBA8;
     colorType = kRGBA_8888_SkColorType;
@@ -529,50 +666,39 @@ SkiaApp::SkiaApp()
 	}
 #endif
 
-	printf("EMSC:: Creating GrBackendRenderTarget\n");
-  GrBackendRenderTarget target(viewWidth, viewHeight, kMsaaSampleCount, kStencilBits, info);
-
 	// setup SkSurface
-	printf("EMSC:: Setting up SkSurface\n");
-	// To use distance field text, use commented out SkSurfaceProps instead
-	// SkSurfaceProps props(SkSurfaceProps::kUseDeviceIndependentFonts_Flag,
-	// 	SkSurfaceProps::kLegacyFontHost_InitType);
-	SkSurfaceProps props(SkSurfaceProps::kLegacyFontHost_InitType);
 	printf("EMSC:: Creating SkSurface from MakeFromBackendRenderTarget\n");
-	surface = SkSurface::MakeFromBackendRenderTarget(grContext.get(), target,
-		kBottomLeft_GrSurfaceOrigin,
-		colorType, nullptr, &props);
-  assert(surface);
+	makeWindowSurface();
 
   printf("EMSC:: Getting canvas from SkSurface\n");
   auto* canvas = surface->getCanvas();
   assert(canvas);
 	// canvas->scale((float)dw / displayMode.w, (float)dh / displayMode.h);
 
-	paint.setAntiAlias(true);
+	printf("EMSC:: Creating retained frame layer\n");
+	damage.setSurfaceSize(viewWidth, viewHeight);
+	resizeLayer();
 
-	// create a surface for CPU rasterization
-	printf("EMSC:: create a surface for CPU rasterization\n");
-	cpuSurface = SkSurface::MakeRaster(canvas->imageInfo());
-  assert(cpuSurface);
-
-	auto* offscreen = cpuSurface->getCanvas();
-  assert(offscreen);
-
-	offscreen->save();
-	offscreen->translate(50.0f, 50.0f);
-	offscreen->drawPath(create_star(), paint);
-	offscreen->restore();
-
-  image = cpuSurface->makeImageSnapshot();
-  assert(image);
+	paint.setAntiAlias(true);
 
-  printf("EMSC:: Creating typeface for font rendering\n");
-  typeface = SkTypeface::MakeFromData(
-      SkData::MakeWithoutCopy(dataKarlaRegular, sizeof(dataKarlaRegular)));
+	// the star is rendered into the sprite atlas on first use
+	printf("EMSC:: Adding the star sprite\n");
+	SkPath star = create_star();
+	starBounds = star.getBounds();
+	starSprite = sprites.add(starBounds.makeOutset(1, 1), [star](SkCanvas* spriteCanvas) {
+		SkPaint starPaint;
+		starPaint.setAntiAlias(true);
+		spriteCanvas->drawPath(star, starPaint);
+	});
+
+	starAnimation = scheduler.addAnimation();
+	scheduler.setAnimationRunning(starAnimation, true);
+#ifdef SK_BUILD_FOR_WASM
+	// The browser drives the main loop, it is paused while idle and resumed by the next event
+	scheduler.setWakeCallback([] { emscripten_resume_main_loop(); });
+	SDL_AddEventWatch(SkiaApp::event_watch, this);
+#endif
 
-  font.setTypeface(typeface);
-	font.setSize(24);
 	printf("EMSC:: App initialization is completed\n");
 }
 
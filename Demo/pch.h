@@ -38,6 +38,7 @@
 #if defined(SK_BUILD_FOR_WASM)
 #include <emscripten.h>
 #include <emscripten/html5.h>
+#include <emscripten/threading.h>
 #include <GL/gl.h>
 #elif defined(SK_BUILD_FOR_ANDROID)
 #include <GLES/gl.h>
@@ -0,0 +1,175 @@
+#include "compiled_scene.h"
+
+#include <utility>
+
+#include "include/core/SkCanvas.h"
+
+namespace {
+
+// Shapes without a fillColor keep the colors the renderer has always used for them
+uint32_t resolve_fill(PaintTable& paints, const Shape& shape) {
+	if (shape.fillColor.empty()) {
+		return paints.fill(shape.type == ShapeType::Rectangle ? SK_ColorYELLOW : SK_ColorBLACK);
+	}
+	return paints.fill(shape.fillColor);
+}
+
+uint32_t resolve_stroke(PaintTable& paints, const Shape& shape) {
+	if (shape.strokeColor.empty()) {
+		return PaintTable::kNoPaint;
+	}
+	return paints.stroke(shape.strokeColor, static_cast<float>(shape.strokeWidth));
+}
+
+// FontWeight lists the CSS weights in order, Thin being 100
+int font_weight(FontWeight weight) {
+	if (weight == FontWeight::Unknown) {
+		return 400;
+	}
+	return (static_cast<int>(weight) + 1) * 100;
+}
+
+} // namespace
+
+void CompiledScene::clear() {
+	fOps.clear();
+	fRects.clear();
+	fTexts.clear();
+	fPaints.clear();
+	fIndex.clear();
+}
+
+void CompiledScene::build(const Elements& elements, const SkFont& font, TypefaceRegistry* typefaces) {
+	clear();
+
+	size_t rectCount = 0;
+	size_t textCount = 0;
+	for (const Shape& shape : elements.elements) {
+		if (shape.type == ShapeType::Rectangle) {
+			++rectCount;
+		} else if (shape.type == ShapeType::Text) {
+			++textCount;
+		}
+	}
+
+	fOps.reserve(rectCount + textCount);
+	fRects.reserve(rectCount);
+	fTexts.reserve(textCount);
+
+	SkFont shapeFont = font;
+
+	for (const Shape& shape : elements.elements) {
+		// Shapes of a type this renderer does not know are skipped, as they always were
+		if (shape.type == ShapeType::Unknown) {
+			continue;
+		}
+
+		const Properties& props = shape.props;
+		uint32_t fill = resolve_fill(fPaints, shape);
+		uint32_t stroke = resolve_stroke(fPaints, shape);
+
+		switch (shape.type) {
+		case ShapeType::Rectangle: {
+			// A usable gradient takes precedence over fillColor
+			sk_sp<SkShader> gradient = fShaders.get(shape.gradient, props.width, props.height);
+			bool localFill = gradient != nullptr;
+			if (localFill) {
+				fill = fPaints.fill(std::move(gradient));
+			}
+
+			fOps.push_back({Kind::Rect, static_cast<uint32_t>(fRects.size())});
+			fRects.push_back({SkRect::MakeXYWH(props.x, props.y, props.width, props.height), fill, stroke, localFill});
+			break;
+		}
+		case ShapeType::Text: {
+			sk_sp<SkTypeface> typeface = typefaces ? typefaces->match(shape.fontFamily, font_weight(shape.fontWeight)) : nullptr;
+			shapeFont.setTypeface(typeface ? std::move(typeface) : font.refTypeface());
+			shapeFont.setSize(shape.fontSize > 0 ? shape.fontSize : font.getSize());
+			sk_sp<SkTextBlob> blob = fTextBlobs.get(shape.value, shapeFont, static_cast<float>(shape.letterSpacing));
+			if (!blob) {
+				break;
+			}
+
+			fOps.push_back({Kind::Text, static_cast<uint32_t>(fTexts.size())});
+			fTexts.push_back({SkPoint::Make(props.x, props.y), std::move(blob), fill, stroke});
+			break;
+		}
+		case ShapeType::Unknown:
+			break;
+		}
+	}
+
+	std::vector<SkRect> bounds(fOps.size());
+	for (size_t i = 0; i < fOps.size(); ++i) {
+		bounds[i] = computeBounds(fOps[i]);
+	}
+	fIndex.build(bounds);
+}
+
+SkRect CompiledScene::computeBounds(const DrawOp& op) const {
+	SkRect bounds;
+	uint32_t stroke;
+	if (op.kind == Kind::Rect) {
+		const RectShape& shape = fRects[op.index];
+		bounds = shape.rect.makeSorted();
+		stroke = shape.stroke;
+	} else {
+		const TextShape& shape = fTexts[op.index];
+		bounds = shape.blob->bounds().makeOffset(shape.origin.fX, shape.origin.fY);
+		stroke = shape.stroke;
+	}
+
+	// Half the stroke lies outside the geometry, plus a pixel of antialiasing
+	float outset = 1;
+	if (stroke != PaintTable::kNoPaint) {
+		outset += fPaints[stroke].getStrokeWidth() / 2;
+	}
+	return bounds.makeOutset(outset, outset);
+}
+
+void CompiledScene::setRect(uint32_t op, const SkRect& rect) {
+	fRects[fOps[op].index].rect = rect;
+	fIndex.update(op, computeBounds(fOps[op]));
+}
+
+void CompiledScene::setTextOrigin(uint32_t op, SkPoint origin) {
+	fTexts[fOps[op].index].origin = origin;
+	fIndex.update(op, computeBounds(fOps[op]));
+}
+
+void CompiledScene::draw(SkCanvas* canvas) const {
+	fIndex.query(canvas->getLocalClipBounds(), &fVisible);
+	for (uint32_t op : fVisible) {
+		drawOp(canvas, fOps[op]);
+	}
+}
+
+void CompiledScene::drawOp(SkCanvas* canvas, const DrawOp& op) const {
+	switch (op.kind) {
+	case Kind::Rect: {
+		const RectShape& shape = fRects[op.index];
+		if (shape.localFill) {
+			canvas->save();
+			canvas->translate(shape.rect.fLeft, shape.rect.fTop);
+			canvas->drawRect(SkRect::MakeWH(shape.rect.width(), shape.rect.height()), fPaints[shape.fill]);
+			canvas->restore();
+		} else if (shape.fill != PaintTable::kNoPaint) {
+			canvas->drawRect(shape.rect, fPaints[shape.fill]);
+		}
+		if (shape.stroke != PaintTable::kNoPaint) {
+			canvas->drawRect(shape.rect, fPaints[shape.stroke]);
+		}
+		break;
+	}
+	case Kind::Text: {
+		const TextShape& shape = fTexts[op.index];
+		if (shape.fill != PaintTable::kNoPaint) {
+			canvas->drawTextBlob(shape.blob, shape.origin.fX, shape.origin.fY, fPaints[shape.fill]);
+		}
+		if (shape.stroke != PaintTable::kNoPaint) {
+			canvas->drawTextBlob(shape.blob, shape.origin.fX, shape.origin.fY, fPaints[shape.stroke]);
+		}
+		break;
+	}
+	}
+}
@@ -0,0 +1,98 @@
+#ifndef COMPILED_SCENE_H
+#define COMPILED_SCENE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "include/core/SkFont.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkTextBlob.h"
+
+#include "paint_table.h"
+#include "scene_data.h"
+#include "shader_cache.h"
+#include "spatial_index.h"
+#include "text_blob_cache.h"
+#include "typeface_registry.h"
+
+class SkCanvas;
+
+/*
+ * Render-ready form of the mapped Elements, built once after mapping.
+ * Shapes are kept in contiguous arrays with their geometry already converted to Skia
+ * types and their colors resolved to PaintTable indices, so drawing a frame walks plain arrays
+ * without allocating or looking at strings. A SpatialIndex over the shape bounds limits
+ * drawing to the shapes that intersect the canvas clip.
+ */
+class CompiledScene {
+public:
+	enum class Kind : uint8_t {
+		Rect,
+		Text,
+	};
+
+	// One entry per shape in document order; index points into rects() or texts()
+	struct DrawOp {
+		Kind kind;
+		uint32_t index;
+	};
+
+	// fill and stroke are PaintTable indices, either may be PaintTable::kNoPaint.
+	// A local fill is a gradient from the ShaderCache, defined relative to the rect origin.
+	struct RectShape {
+		SkRect rect;
+		uint32_t fill;
+		uint32_t stroke;
+		bool localFill;
+	};
+
+	// The blob is laid out from (0, 0) on the baseline and shared with equal labels
+	struct TextShape {
+		SkPoint origin;
+		sk_sp<SkTextBlob> blob;
+		uint32_t fill;
+		uint32_t stroke;
+	};
+
+	// Text is shaped at the shape fontSize, or else the font size. The typeface is matched in
+	// typefaces by fontFamily and fontWeight; without a registry or a match, font's is used.
+	void build(const Elements& elements, const SkFont& font, TypefaceRegistry* typefaces = nullptr);
+	void clear();
+
+	// Draws the shapes intersecting the canvas clip, in document order. Not thread safe,
+	// the visible set is collected into a buffer owned by the scene.
+	void draw(SkCanvas* canvas) const;
+
+	// Edits keep the spatial index up to date. op is a position in ops() of the matching kind.
+	// A gradient fill keeps the size it was compiled for.
+	void setRect(uint32_t op, const SkRect& rect);
+	void setTextOrigin(uint32_t op, SkPoint origin);
+
+	// Scene space bounds of everything op draws, stroke and antialiasing included
+	const SkRect& bounds(uint32_t op) const { return fIndex.bounds(op); }
+
+	size_t size() const { return fOps.size(); }
+	const std::vector<DrawOp>& ops() const { return fOps; }
+	const std::vector<RectShape>& rects() const { return fRects; }
+	const std::vector<TextShape>& texts() const { return fTexts; }
+	const PaintTable& paints() const { return fPaints; }
+
+private:
+	void drawOp(SkCanvas* canvas, const DrawOp& op) const;
+	SkRect computeBounds(const DrawOp& op) const;
+
+	std::vector<DrawOp> fOps;
+	std::vector<RectShape> fRects;
+	std::vector<TextShape> fTexts;
+	PaintTable fPaints;
+	// Kept across builds, reloading a scene with the same styles reuses the shaders and blobs.
+	// Both are bounded LRUs, so a long-lived renderer does not grow them without limit.
+	ShaderCache fShaders;
+	TextBlobCache fTextBlobs;
+	SpatialIndex fIndex;
+	mutable std::vector<uint32_t> fVisible;
+};
+
+#endif //COMPILED_SCENE_H
@@ -0,0 +1,111 @@
+#include "damage_tracker.h"
+
+#include <algorithm>
+
+namespace {
+
+int64_t area(const SkIRect& rect) {
+	return static_cast<int64_t>(rect.width()) * rect.height();
+}
+
+SkIRect join(SkIRect a, const SkIRect& b) {
+	a.join(b);
+	return a;
+}
+
+} // namespace
+
+void DamageTracker::setSurfaceSize(int width, int height) {
+	SkIRect bounds = SkIRect::MakeWH(width, height);
+	if (bounds != fSurfaceBounds) {
+		fSurfaceBounds = bounds;
+		invalidateAll();
+	}
+}
+
+void DamageTracker::invalidateAll() {
+	fRects.clear();
+	if (!fSurfaceBounds.isEmpty()) {
+		fRects.push_back(fSurfaceBounds);
+	}
+}
+
+void DamageTracker::add(const SkRect& bounds) {
+	add(bounds.makeSorted().roundOut());
+}
+
+void DamageTracker::add(const SkIRect& bounds) {
+	SkIRect rect = bounds;
+	if (!rect.intersect(fSurfaceBounds)) {
+		return;
+	}
+
+	// Absorb every rect that costs no extra pixels to redraw together with this one
+	for (size_t i = 0; i < fRects.size();) {
+		SkIRect merged = join(rect, fRects[i]);
+		if (area(merged) <= area(rect) + area(fRects[i])) {
+			rect = merged;
+			fRects.erase(fRects.begin() + i);
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	fRects.push_back(rect);
+	if (fRects.size() > kMaxRects) {
+		mergeCheapestPair();
+	}
+}
+
+void DamageTracker::addMove(const SkRect& oldBounds, const SkRect& newBounds) {
+	add(oldBounds);
+	add(newBounds);
+}
+
+void DamageTracker::mergeCheapestPair() {
+	size_t bestA = 0;
+	size_t bestB = 1;
+	int64_t bestCost = INT64_MAX;
+	for (size_t a = 0; a < fRects.size(); ++a) {
+		for (size_t b = a + 1; b < fRects.size(); ++b) {
+			int64_t cost = area(join(fRects[a], fRects[b])) - area(fRects[a]) - area(fRects[b]);
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestA = a;
+				bestB = b;
+			}
+		}
+	}
+
+	fRects[bestA].join(fRects[bestB]);
+	fRects.erase(fRects.begin() + bestB);
+}
+
+SkIRect DamageTracker::bounds() const {
+	SkIRect result = SkIRect::MakeEmpty();
+	for (const SkIRect& rect : fRects) {
+		result.join(rect);
+	}
+	return result;
+}
+
+float DamageTracker::coverage() const {
+	if (fSurfaceBounds.isEmpty()) {
+		return 0;
+	}
+
+	// Rects are only merged when that pays off, so they may still overlap; pairwise overlaps are
+	// subtracted, which is exact unless three rects share pixels
+	int64_t total = 0;
+	for (size_t i = 0; i < fRects.size(); ++i) {
+		total += area(fRects[i]);
+		for (size_t j = i + 1; j < fRects.size(); ++j) {
+			SkIRect overlap = fRects[i];
+			if (overlap.intersect(fRects[j])) {
+				total -= area(overlap);
+			}
+		}
+	}
+	return std::min(1.0f, static_cast<float>(total) / area(fSurfaceBounds));
+}
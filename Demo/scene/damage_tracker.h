@@ -0,0 +1,43 @@
+#ifndef DAMAGE_TRACKER_H
+#define DAMAGE_TRACKER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "include/core/SkRect.h"
+
+/*
+ * Device space regions that changed since the last frame.
+ * Added bounds are rounded out to pixels, clipped to the surface and merged with the
+ * regions they overlap, so a frame only has to clear and redraw a few rects. Moving content
+ * must add both its old and new bounds.
+ */
+class DamageTracker {
+public:
+	// Resizing damages the whole surface
+	void setSurfaceSize(int width, int height);
+
+	void add(const SkRect& bounds);
+	void add(const SkIRect& bounds);
+	void addMove(const SkRect& oldBounds, const SkRect& newBounds);
+	void invalidateAll();
+
+	bool isEmpty() const { return fRects.empty(); }
+	const std::vector<SkIRect>& rects() const { return fRects; }
+	SkIRect bounds() const;
+	// Damaged area as a fraction of the surface; overlapping rects are not double counted
+	float coverage() const;
+
+	// Forget the damage once the frame has been drawn
+	void reset() { fRects.clear(); }
+
+private:
+	static constexpr size_t kMaxRects = 4;
+
+	void mergeCheapestPair();
+
+	SkIRect fSurfaceBounds = SkIRect::MakeEmpty();
+	std::vector<SkIRect> fRects;
+};
+
+#endif //DAMAGE_TRACKER_H
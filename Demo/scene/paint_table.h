@@ -0,0 +1,56 @@
+#ifndef PAINT_TABLE_H
+#define PAINT_TABLE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "include/core/SkColor.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkShader.h"
+
+/*
+ * Deduplicated fill and stroke paints of a scene.
+ * Colors are parsed once at load time and every distinct (style, color, width) gets a single
+ * SkPaint; shapes keep the returned index and the renderer looks the paint up per draw.
+ */
+class PaintTable {
+public:
+	static constexpr uint32_t kNoPaint = UINT32_MAX;
+
+	// CSS colors: #rgb, #rgba, #rrggbb, #rrggbbaa and the named colors, case-insensitive.
+	// "none" and "transparent" parse to a fully transparent color.
+	static std::optional<SkColor> parseColor(const std::string& value);
+
+	// Both return kNoPaint when the color is "none", fully transparent or cannot be parsed;
+	// stroke() also does for a width that is not positive
+	uint32_t fill(const std::string& color);
+	uint32_t stroke(const std::string& color, float width);
+
+	uint32_t fill(SkColor color);
+	uint32_t stroke(SkColor color, float width);
+
+	// Fill with a shader, deduplicated by shader instance
+	uint32_t fill(sk_sp<SkShader> shader);
+
+	const SkPaint& operator[](uint32_t index) const { return fPaints[index]; }
+	size_t size() const { return fPaints.size(); }
+	void clear();
+
+private:
+	uint32_t add(SkPaint::Style style, SkColor color, float width);
+	uint32_t add(sk_sp<SkShader> shader);
+	std::optional<SkColor> resolve(const std::string& value);
+
+	std::vector<SkPaint> fPaints;
+	std::unordered_map<SkColor, uint32_t> fFillIndex;
+	std::unordered_map<uint64_t, uint32_t> fStrokeIndex;
+	std::unordered_map<const SkShader*, uint32_t> fShaderIndex;
+	// Parsed color strings, shared by fills and strokes
+	std::unordered_map<std::string, std::optional<SkColor>> fColors;
+};
+
+#endif //PAINT_TABLE_H
@@ -0,0 +1,88 @@
+#include "raster_backend.h"
+
+#include <cstdio>
+#include <utility>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkStream.h"
+#include "include/encode/SkPngEncoder.h"
+
+#include "scene_renderer.h"
+#include "tiled_rasterizer.h"
+
+RasterBackend::RasterBackend(int width, int height, float scale, SurfacePool& pool)
+	: fPool(pool), fScale(scale) {
+	resize(width, height);
+}
+
+bool RasterBackend::resize(int width, int height) {
+	if (fSurface && fSurface->width() == width && fSurface->height() == height) {
+		return true;
+	}
+
+	sk_sp<SkSurface> surface = fPool.makeSurface(SkImageInfo::MakeN32Premul(width, height));
+	if (!surface) {
+		return false;
+	}
+	fSurface = std::move(surface);
+	return true;
+}
+
+void RasterBackend::render(SceneRenderer& scene) {
+	if (!fSurface) {
+		return;
+	}
+
+	SkCanvas* canvas = fSurface->getCanvas();
+	canvas->save();
+	canvas->scale(fScale, fScale);
+	scene.draw(canvas, sceneBounds());
+	canvas->restore();
+}
+
+// The tiles write straight into the surface pixels, there is no snapshot sharing them
+void RasterBackend::render(SceneRenderer& scene, TiledRasterizer& tiles) {
+	SkPixmap pixmap;
+	if (!pixels(&pixmap)) {
+		return;
+	}
+	tiles.render(*scene.picture(sceneBounds()), fScale, pixmap);
+}
+
+SkRect RasterBackend::sceneBounds() const {
+	return SkRect::MakeWH(fSurface->width() / fScale, fSurface->height() / fScale);
+}
+
+bool RasterBackend::pixels(SkPixmap* pixmap) const {
+	return fSurface && fSurface->peekPixels(pixmap);
+}
+
+sk_sp<SkData> RasterBackend::encodePNG(int zlibLevel) const {
+	SkPixmap pixmap;
+	if (!pixels(&pixmap)) {
+		return nullptr;
+	}
+
+	SkPngEncoder::Options options;
+	options.fZLibLevel = zlibLevel;
+	SkDynamicMemoryWStream stream;
+	if (!SkPngEncoder::Encode(&stream, pixmap, options)) {
+		return nullptr;
+	}
+	return stream.detachAsData();
+}
+
+bool RasterBackend::writePNG(const std::string& path, int zlibLevel) const {
+	sk_sp<SkData> png = encodePNG(zlibLevel);
+	if (!png) {
+		return false;
+	}
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	bool written = fwrite(png->data(), 1, png->size(), file) == png->size();
+	return fclose(file) == 0 && written;
+}
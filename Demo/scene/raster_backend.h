@@ -0,0 +1,55 @@
+#ifndef RASTER_BACKEND_H
+#define RASTER_BACKEND_H
+
+#include <string>
+
+#include "include/core/SkData.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSurface.h"
+
+#include "surface_pool.h"
+
+class SceneRenderer;
+class TiledRasterizer;
+
+/*
+ * Headless render target: a CPU raster surface, no window and no GL context.
+ * Scenes are drawn at `scale` pixels per scene unit, so a thumbnail can render the same
+ * scene area at a lower resolution. The pixels stay owned by the backend and are valid until
+ * the next render or resize. Surfaces come from a SurfacePool, so backends rendering
+ * thumbnails or exports of recurring sizes reuse the same pixel buffers.
+ */
+class RasterBackend {
+public:
+	RasterBackend(int width, int height, float scale = 1, SurfacePool& pool = SurfacePool::Default());
+
+	// Returns false and keeps the current surface when the size cannot be allocated
+	bool resize(int width, int height);
+	void setScale(float scale) { fScale = scale; }
+
+	bool isValid() const { return fSurface != nullptr; }
+	int width() const { return fSurface ? fSurface->width() : 0; }
+	int height() const { return fSurface ? fSurface->height() : 0; }
+	float scale() const { return fScale; }
+	SkCanvas* canvas() const { return fSurface ? fSurface->getCanvas() : nullptr; }
+
+	void render(SceneRenderer& scene);
+	// Same image, rasterized in tiles on the rasterizer's threads
+	void render(SceneRenderer& scene, TiledRasterizer& tiles);
+
+	// Premultiplied N32 pixels of the last render
+	bool pixels(SkPixmap* pixmap) const;
+	// zlibLevel trades size for speed, 1 is fastest and 9 is smallest
+	sk_sp<SkData> encodePNG(int zlibLevel = 6) const;
+	bool writePNG(const std::string& path, int zlibLevel = 6) const;
+
+private:
+	SkRect sceneBounds() const;
+
+	SurfacePool& fPool;
+	sk_sp<SkSurface> fSurface;
+	float fScale;
+};
+
+#endif //RASTER_BACKEND_H
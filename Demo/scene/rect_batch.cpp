@@ -0,0 +1,71 @@
+#include "rect_batch.h"
+
+#include <iterator>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPaint.h"
+
+void RectBatch::add(const SkRect& rect, SkColor color) {
+	SkRect sorted = rect.makeSorted();
+	if (sorted.isEmpty()) {
+		return;
+	}
+
+	if (fChunks.empty() || fChunks.back().count == kRectsPerChunk) {
+		fChunks.emplace_back();
+	}
+
+	Chunk& chunk = fChunks.back();
+	chunk.positions.push_back(SkPoint::Make(sorted.fLeft, sorted.fTop));
+	chunk.positions.push_back(SkPoint::Make(sorted.fRight, sorted.fTop));
+	chunk.positions.push_back(SkPoint::Make(sorted.fRight, sorted.fBottom));
+	chunk.positions.push_back(SkPoint::Make(sorted.fLeft, sorted.fBottom));
+	chunk.colors.insert(chunk.colors.end(), 4, color);
+	chunk.vertices.reset();
+
+	size_t rectIndex = chunk.count++;
+	if (fIndices.size() < chunk.count * 6) {
+		uint16_t first = static_cast<uint16_t>(rectIndex * 4);
+		const uint16_t indices[] = {first, uint16_t(first + 1), uint16_t(first + 2), first, uint16_t(first + 2), uint16_t(first + 3)};
+		fIndices.insert(fIndices.end(), std::begin(indices), std::end(indices));
+	}
+
+	++fCount;
+	fBounds.join(sorted);
+}
+
+void RectBatch::clear() {
+	fChunks.clear();
+	fCount = 0;
+	fBounds.setEmpty();
+}
+
+size_t RectBatch::memoryUsage() const {
+	size_t bytes = fIndices.capacity() * sizeof(uint16_t);
+	for (const Chunk& chunk : fChunks) {
+		bytes += chunk.positions.capacity() * sizeof(SkPoint) + chunk.colors.capacity() * sizeof(SkColor);
+		if (chunk.vertices) {
+			bytes += chunk.vertices->approximateSize();
+		}
+	}
+	return bytes;
+}
+
+void RectBatch::draw(SkCanvas* canvas) {
+	SkPaint paint;
+	for (Chunk& chunk : fChunks) {
+		if (!chunk.vertices) {
+			chunk.vertices = SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, static_cast<int>(chunk.count * 4),
+				chunk.positions.data(), nullptr, chunk.colors.data(),
+				static_cast<int>(chunk.count * 6), fIndices.data());
+
+			// A full chunk never changes again, only its vertices are needed from now on
+			if (chunk.count == kRectsPerChunk) {
+				chunk.positions = {};
+				chunk.colors = {};
+			}
+		}
+
+		canvas->drawVertices(chunk.vertices, SkBlendMode::kModulate, paint);
+	}
+}
@@ -0,0 +1,51 @@
+#ifndef RECT_BATCH_H
+#define RECT_BATCH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "include/core/SkColor.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkVertices.h"
+
+class SkCanvas;
+
+/*
+ * Solid rects drawn as colored triangles, one drawVertices call per chunk of rects.
+ * SkVertices indices are 16 bit, so rects are grouped in chunks of 16384. Full chunks are
+ * immutable and keep only their SkVertices; adding a rect rebuilds the last chunk on the
+ * next draw. Rects are drawn in insertion order and blend with each other like drawRect.
+ */
+class RectBatch {
+public:
+	void add(const SkRect& rect, SkColor color);
+	void clear();
+
+	size_t size() const { return fCount; }
+	bool isEmpty() const { return fCount == 0; }
+	const SkRect& bounds() const { return fBounds; }
+	// Bytes held by the rect data and built vertices
+	size_t memoryUsage() const;
+
+	void draw(SkCanvas* canvas);
+
+private:
+	static constexpr size_t kRectsPerChunk = 16384;
+
+	struct Chunk {
+		size_t count = 0;
+		std::vector<SkPoint> positions;
+		std::vector<SkColor> colors;
+		sk_sp<SkVertices> vertices;
+	};
+
+	std::vector<Chunk> fChunks;
+	// Two triangles per rect, shared by every chunk
+	std::vector<uint16_t> fIndices;
+	size_t fCount = 0;
+	SkRect fBounds = SkRect::MakeEmpty();
+};
+
+#endif //RECT_BATCH_H
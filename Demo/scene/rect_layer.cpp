@@ -0,0 +1,124 @@
+#include "rect_layer.h"
+
+#include <cmath>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkSurface.h"
+
+uint64_t RectLayer::tileKey(int32_t x, int32_t y) {
+	return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+// Inclusive range of the tiles covering bounds
+SkIRect RectLayer::tileRange(const SkRect& bounds) {
+	return SkIRect::MakeLTRB(
+		static_cast<int32_t>(std::floor(bounds.fLeft / kTileSize)),
+		static_cast<int32_t>(std::floor(bounds.fTop / kTileSize)),
+		static_cast<int32_t>(std::floor(bounds.fRight / kTileSize)),
+		static_cast<int32_t>(std::floor(bounds.fBottom / kTileSize)));
+}
+
+void RectLayer::add(const SkRect& rect, SkColor color) {
+	SkRect sorted = rect.makeSorted();
+	if (sorted.isEmpty()) {
+		return;
+	}
+
+	fPending.add(sorted, color);
+
+	SkIRect range = tileRange(sorted);
+	for (int32_t y = range.fTop; y <= range.fBottom; ++y) {
+		for (int32_t x = range.fLeft; x <= range.fRight; ++x) {
+			uint64_t key = tileKey(x, y);
+			Tile& tile = fTiles[key];
+			tile.x = x;
+			tile.y = y;
+			if (!tile.dirty) {
+				tile.dirty = true;
+				fDirtyTiles.push_back(key);
+			}
+		}
+	}
+}
+
+void RectLayer::clear() {
+	fPending.clear();
+	fBakedCount = 0;
+	fTiles.clear();
+	fDirtyTiles.clear();
+}
+
+size_t RectLayer::tileBytes() const {
+	return fTiles.size() * kTileSize * kTileSize * sizeof(uint32_t);
+}
+
+bool RectLayer::needsBake() const {
+	return fPending.size() >= fPolicy.maxPendingRects || fPending.memoryUsage() >= fPolicy.maxPendingBytes;
+}
+
+void RectLayer::bake(SkCanvas* canvas) {
+	for (uint64_t key : fDirtyTiles) {
+		bakeTile(canvas, fTiles[key]);
+	}
+	fDirtyTiles.clear();
+
+	fBakedCount += fPending.size();
+	fPending.clear();
+}
+
+void RectLayer::bakeTile(SkCanvas* canvas, Tile& tile) {
+	SkImageInfo info = SkImageInfo::MakeN32Premul(kTileSize, kTileSize);
+	// Tiles baked on the GPU stay there; canvases without a surface get raster tiles
+	sk_sp<SkSurface> surface = canvas->makeSurface(info);
+	if (!surface) {
+		surface = SkSurface::MakeRaster(info);
+	}
+
+	SkCanvas* tileCanvas = surface->getCanvas();
+	tileCanvas->clear(SK_ColorTRANSPARENT);
+	if (tile.image) {
+		tileCanvas->drawImage(tile.image, 0, 0);
+	}
+	tileCanvas->translate(-static_cast<float>(tile.x) * kTileSize, -static_cast<float>(tile.y) * kTileSize);
+	fPending.draw(tileCanvas);
+
+	tile.image = surface->makeImageSnapshot();
+	tile.dirty = false;
+}
+
+void RectLayer::drawTile(SkCanvas* canvas, const Tile& tile) const {
+	if (tile.image) {
+		canvas->drawImage(tile.image, static_cast<float>(tile.x) * kTileSize, static_cast<float>(tile.y) * kTileSize);
+	}
+}
+
+void RectLayer::draw(SkCanvas* canvas) {
+	if (needsBake()) {
+		bake(canvas);
+	}
+
+	// Look the visible tiles up, unless there are fewer tiles than that in total
+	SkIRect range = tileRange(canvas->getLocalClipBounds());
+	int64_t visibleCount = (int64_t(range.fRight) - range.fLeft + 1) * (int64_t(range.fBottom) - range.fTop + 1);
+	if (visibleCount <= static_cast<int64_t>(fTiles.size())) {
+		for (int32_t y = range.fTop; y <= range.fBottom; ++y) {
+			for (int32_t x = range.fLeft; x <= range.fRight; ++x) {
+				auto tile = fTiles.find(tileKey(x, y));
+				if (tile != fTiles.end()) {
+					drawTile(canvas, tile->second);
+				}
+			}
+		}
+	} else {
+		for (const auto& tile : fTiles) {
+			const Tile& t = tile.second;
+			if (t.x >= range.fLeft && t.x <= range.fRight && t.y >= range.fTop && t.y <= range.fBottom) {
+				drawTile(canvas, t);
+			}
+		}
+	}
+
+	fPending.draw(canvas);
+}
@@ -0,0 +1,75 @@
+#ifndef RECT_LAYER_H
+#define RECT_LAYER_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "include/core/SkColor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+
+#include "rect_batch.h"
+
+class SkCanvas;
+
+/*
+ * User rectangles flattened into cached tiles.
+ * New rects are kept in a RectBatch and drawn on top of the tiles until the batch reaches
+ * the bake policy limits; the next draw then renders the batch into every tile it touches
+ * and drops it. A frame therefore costs at most one image per visible tile plus a bounded
+ * number of rects, however many rects were added. Tiles are only created where rects were
+ * drawn and are rendered with the target canvas' backend when it has one.
+ */
+class RectLayer {
+public:
+	static constexpr int kTileSize = 512;
+
+	struct BakePolicy {
+		// Bake once this many rects are waiting...
+		size_t maxPendingRects = 512;
+		// ...or once their vertex data takes this many bytes
+		size_t maxPendingBytes = 256 * 1024;
+	};
+
+	void setBakePolicy(const BakePolicy& policy) { fPolicy = policy; }
+
+	void add(const SkRect& rect, SkColor color);
+	void clear();
+
+	// Every rect added so far, baked or not
+	size_t size() const { return fBakedCount + fPending.size(); }
+	size_t pendingCount() const { return fPending.size(); }
+	size_t tileCount() const { return fTiles.size(); }
+	size_t tileBytes() const;
+
+	// Bakes if the policy asks for it, then draws the tiles and pending rects inside the clip
+	void draw(SkCanvas* canvas);
+	// Renders the pending rects into the tiles now
+	void bake(SkCanvas* canvas);
+
+private:
+	struct Tile {
+		int32_t x = 0;
+		int32_t y = 0;
+		sk_sp<SkImage> image;
+		bool dirty = false;
+	};
+
+	static uint64_t tileKey(int32_t x, int32_t y);
+	static SkIRect tileRange(const SkRect& bounds);
+
+	bool needsBake() const;
+	void bakeTile(SkCanvas* canvas, Tile& tile);
+	void drawTile(SkCanvas* canvas, const Tile& tile) const;
+
+	BakePolicy fPolicy;
+	RectBatch fPending;
+	size_t fBakedCount = 0;
+	std::unordered_map<uint64_t, Tile> fTiles;
+	// Keys of the tiles the pending rects touch
+	std::vector<uint64_t> fDirtyTiles;
+};
+
+#endif //RECT_LAYER_H
@@ -0,0 +1,34 @@
+#include "redraw_scheduler.h"
+
+int RedrawScheduler::addAnimation() {
+	fAnimations.push_back(false);
+	return static_cast<int>(fAnimations.size() - 1);
+}
+
+void RedrawScheduler::setAnimationRunning(int animation, bool running) {
+	if (fAnimations[animation] == running) {
+		return;
+	}
+
+	fAnimations[animation] = running;
+	fRunningAnimations += running ? 1 : -1;
+	if (running) {
+		wake();
+	}
+}
+
+void RedrawScheduler::requestFrame() {
+	fFrameRequested = true;
+	wake();
+}
+
+void RedrawScheduler::wake() {
+	if (!fSleeping) {
+		return;
+	}
+
+	fSleeping = false;
+	if (fWake) {
+		fWake();
+	}
+}
@@ -0,0 +1,45 @@
+#ifndef REDRAW_SCHEDULER_H
+#define REDRAW_SCHEDULER_H
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+/*
+ * Decides whether the next frame has to be rendered at all.
+ * Running animations and explicit requests (input, scene changes) keep frames coming; when
+ * there are none the main loop goes to sleep and is woken up through the wake callback,
+ * which resumes it on platforms where the loop is driven from outside.
+ */
+class RedrawScheduler {
+public:
+	using WakeCallback = std::function<void()>;
+
+	// Called when a frame is needed while the loop sleeps
+	void setWakeCallback(WakeCallback callback) { fWake = std::move(callback); }
+
+	// Animations are registered once and then started and stopped as they need frames
+	int addAnimation();
+	void setAnimationRunning(int animation, bool running);
+	bool isAnimationRunning(int animation) const { return fAnimations[animation]; }
+	bool isAnimating() const { return fRunningAnimations > 0; }
+
+	// A single frame, e.g. after input changed something
+	void requestFrame();
+	bool hasPendingFrame() const { return fFrameRequested || fRunningAnimations > 0; }
+
+	// The loop calls frameDone() after rendering and sleep() before it stops polling
+	void frameDone() { fFrameRequested = false; }
+	void sleep() { fSleeping = true; }
+	bool isSleeping() const { return fSleeping; }
+	void wake();
+
+private:
+	WakeCallback fWake;
+	std::vector<bool> fAnimations;
+	int fRunningAnimations = 0;
+	bool fFrameRequested = true;
+	bool fSleeping = false;
+};
+
+#endif //REDRAW_SCHEDULER_H
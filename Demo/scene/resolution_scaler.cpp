@@ -0,0 +1,51 @@
+#include "resolution_scaler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+ResolutionScaler::ResolutionScaler(const Options& options)
+	: fOptions(options) {
+	reset();
+}
+
+void ResolutionScaler::setOptions(const Options& options) {
+	fOptions = options;
+	setScale(fScale);
+}
+
+bool ResolutionScaler::addFrame(double frameMs) {
+	fFrames[fFrameCount % kWindow] = frameMs;
+	++fFrameCount;
+	++fFramesAtScale;
+	// Only judge a scale by frames rendered at it
+	if (fFrameCount < kWindow) {
+		return false;
+	}
+
+	const double average = std::accumulate(fFrames.begin(), fFrames.end(), 0.0) / kWindow;
+	const double budget = fOptions.targetFrameMs;
+	const float oldScale = fScale;
+
+	if (average > budget * fOptions.dropAbove && fScale > fOptions.minScale) {
+		// The frame cost follows the pixel count, the square of the scale
+		const float fits = fScale * static_cast<float>(std::sqrt(budget / average));
+		const float step = std::max(fOptions.step, 0.01f);
+		setScale(std::min(std::floor(fits / step) * step, fScale - step));
+	} else if (average < budget * fOptions.raiseBelow && fScale < fOptions.maxScale
+		&& fFramesAtScale >= fOptions.raiseAfterFrames) {
+		setScale(fScale + fOptions.step);
+	}
+
+	return fScale != oldScale;
+}
+
+void ResolutionScaler::reset() {
+	setScale(fOptions.maxScale);
+}
+
+void ResolutionScaler::setScale(float scale) {
+	fScale = std::max(fOptions.minScale, std::min(fOptions.maxScale, scale));
+	fFrameCount = 0;
+	fFramesAtScale = 0;
+}
@@ -0,0 +1,55 @@
+#ifndef RESOLUTION_SCALER_H
+#define RESOLUTION_SCALER_H
+
+#include <array>
+
+/*
+ * Picks the resolution frames are rendered at from the time recent frames took.
+ * When the average of the last frames goes over the budget the scale drops, straight to the
+ * step that should fit since the cost follows the pixel count. It only rises again, one
+ * step at a time, after frames have stayed well under the budget for a while. The gap between
+ * the two thresholds and the wait before rising keep the scale from flickering between steps.
+ * Scales are multiples of the step, so the surfaces rendered into take only a few sizes.
+ */
+class ResolutionScaler {
+public:
+	struct Options {
+		float targetFrameMs = 1000.0f / 60;
+		// The scale drops when frames average more than budget * dropAbove
+		float dropAbove = 1.0f;
+		// and rises when they average less than budget * raiseBelow
+		float raiseBelow = 0.65f;
+		// Frames at the current scale before it may rise
+		int raiseAfterFrames = 60;
+		float minScale = 0.5f;
+		float maxScale = 1;
+		float step = 0.125f;
+		// Overlay text is drawn on top at full resolution instead of being scaled with the frame
+		bool fullResolutionText = true;
+	};
+
+	ResolutionScaler() = default;
+	explicit ResolutionScaler(const Options& options);
+
+	const Options& options() const { return fOptions; }
+	void setOptions(const Options& options);
+
+	// Time the last rendered frame took. Returns true when the scale changed.
+	bool addFrame(double frameMs);
+	float scale() const { return fScale; }
+	// Back to the full scale, e.g. for a last sharp frame before the loop goes idle
+	void reset();
+
+private:
+	static constexpr int kWindow = 8;
+
+	void setScale(float scale);
+
+	Options fOptions;
+	float fScale = 1;
+	std::array<double, kWindow> fFrames = {};
+	int fFrameCount = 0;
+	int fFramesAtScale = 0;
+};
+
+#endif //RESOLUTION_SCALER_H
@@ -0,0 +1,129 @@
+#ifndef SCENE_DATA_H
+#define SCENE_DATA_H
+
+#include <list>
+#include <string>
+
+#include "include/struct_mapping/struct_mapping.h"
+
+// Scene description as it is mapped from the JSON file.
+// Names the renderer does not know map to Unknown instead of failing the whole scene:
+// unknown shapes are skipped, unknown gradients are not painted and unknown weights draw Regular.
+
+enum class ShapeType {
+	Rectangle,
+	Text,
+	Unknown,
+};
+
+enum class GradientType {
+	Linear,
+	Radial,
+	Unknown,
+};
+
+enum class FontWeight {
+	Thin,
+	ExtraLight,
+	Light,
+	Regular,
+	Medium,
+	SemiBold,
+	Bold,
+	ExtraBold,
+	Black,
+	Unknown,
+};
+
+namespace struct_mapping {
+
+template<> struct EnumNames<ShapeType> {
+	static constexpr EnumEntry<ShapeType> entries[] = {
+		{"RECTANGLE", ShapeType::Rectangle},
+		{"TEXT", ShapeType::Text},
+		{"", ShapeType::Unknown},
+	};
+	static constexpr ShapeType fallback = ShapeType::Unknown;
+};
+
+template<> struct EnumNames<GradientType> {
+	static constexpr EnumEntry<GradientType> entries[] = {
+		{"linear", GradientType::Linear},
+		{"radial", GradientType::Radial},
+		{"", GradientType::Unknown},
+	};
+	static constexpr GradientType fallback = GradientType::Unknown;
+};
+
+template<> struct EnumNames<FontWeight> {
+	static constexpr EnumEntry<FontWeight> entries[] = {
+		{"Thin", FontWeight::Thin},
+		{"ExtraLight", FontWeight::ExtraLight},
+		{"Light", FontWeight::Light},
+		{"Regular", FontWeight::Regular},
+		{"Medium", FontWeight::Medium},
+		{"SemiBold", FontWeight::SemiBold},
+		{"Bold", FontWeight::Bold},
+		{"ExtraBold", FontWeight::ExtraBold},
+		{"Black", FontWeight::Black},
+		{"", FontWeight::Unknown},
+		// CSS spellings: lowercase names, keywords and numeric weights
+		{"thin", FontWeight::Thin},
+		{"extralight", FontWeight::ExtraLight},
+		{"light", FontWeight::Light},
+		{"regular", FontWeight::Regular},
+		{"normal", FontWeight::Regular},
+		{"medium", FontWeight::Medium},
+		{"semibold", FontWeight::SemiBold},
+		{"bold", FontWeight::Bold},
+		{"extrabold", FontWeight::ExtraBold},
+		{"black", FontWeight::Black},
+		{"100", FontWeight::Thin},
+		{"200", FontWeight::ExtraLight},
+		{"300", FontWeight::Light},
+		{"400", FontWeight::Regular},
+		{"500", FontWeight::Medium},
+		{"600", FontWeight::SemiBold},
+		{"700", FontWeight::Bold},
+		{"800", FontWeight::ExtraBold},
+		{"900", FontWeight::Black},
+	};
+	static constexpr FontWeight fallback = FontWeight::Unknown;
+};
+
+} // struct_mapping
+
+struct Gradient {
+	std::list<std::string> colors;
+	std::list<std::string> offsets;
+	int angle;
+	std::string direction;
+	GradientType type;
+};
+
+struct Properties {
+	int x;
+	int y;
+	int width;
+	int height;
+};
+
+struct Shape {
+	ShapeType type;
+	Properties props;
+	std::string value;
+	int fontSize;
+	std::string fillColor;
+	std::string strokeColor;
+	int strokeWidth;
+	Gradient gradient;
+	int letterSpacing;
+	std::string fontFamily;
+	FontWeight fontWeight;
+};
+
+struct Elements {
+	std::list <Shape> elements;
+};
+
+#endif //SCENE_DATA_H
@@ -0,0 +1,142 @@
+#include "scene_loader.h"
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <utility>
+
+#include "include/core/SkCanvas.h"
+
+SceneLoader::SceneLoader(const SkRect& bounds, const std::string& fontDirectory)
+	: fRenderer(fontDirectory)
+	, fFont(fRenderer.font())
+	, fBounds(bounds) {
+	// Started last, everything the thread touches is initialized
+	fThread = std::thread([this] { run(); });
+}
+
+SceneLoader::~SceneLoader() {
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fStopping = true;
+	}
+	fWork.notify_all();
+	fThread.join();
+
+	delete fPublished.load();
+	delete fRetired.load();
+	delete fCurrent;
+}
+
+void SceneLoader::load(std::string json) {
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fPendingJson = std::move(json);
+		fHasPending = true;
+	}
+	fWork.notify_one();
+}
+
+void SceneLoader::setBounds(const SkRect& bounds) {
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fBounds = bounds;
+		fBoundsChanged = true;
+	}
+	fWork.notify_one();
+}
+
+bool SceneLoader::update() {
+	SceneSnapshot* next = fPublished.exchange(nullptr, std::memory_order_acq_rel);
+	if (!next) {
+		return false;
+	}
+
+	SceneSnapshot* previous = fCurrent;
+	fCurrent = next;
+	// Only if the loader has not freed the last retired snapshot yet does it die here
+	delete fRetired.exchange(previous, std::memory_order_acq_rel);
+	return true;
+}
+
+void SceneLoader::draw(SkCanvas* canvas) const {
+	canvas->clear(SK_ColorWHITE);
+	if (fCurrent && fCurrent->picture) {
+		canvas->drawPicture(fCurrent->picture);
+	}
+}
+
+void SceneLoader::run() {
+	std::unique_lock<std::mutex> lock(fMutex);
+	for (;;) {
+		fWork.wait(lock, [this] { return fStopping || fHasPending || fBoundsChanged; });
+		if (fStopping) {
+			return;
+		}
+
+		const bool hasJson = fHasPending;
+		std::string json = std::move(fPendingJson);
+		const SkRect bounds = fBounds;
+		fHasPending = false;
+		fBoundsChanged = false;
+
+		lock.unlock();
+		if (hasJson) {
+			build(json, bounds);
+		}
+		// Also when the new JSON failed to map, the current scene gets the new bounds
+		if (fVersion > 0 && fRecordedBounds != bounds) {
+			record(bounds);
+		}
+		lock.lock();
+	}
+}
+
+void SceneLoader::build(const std::string& json, const SkRect& bounds) {
+	auto start = std::chrono::steady_clock::now();
+
+	std::istringstream stream(json);
+	std::string error;
+	if (!fRenderer.load(stream, &error)) {
+		printf("EMSC:: parsing json data failed: %s\n", error.c_str());
+		return;
+	}
+
+	SceneSnapshot* snapshot = makeSnapshot(bounds);
+
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	printf("EMSC:: Scene %llu built in %.1f ms: %zu elements, %zu shapes\n",
+		static_cast<unsigned long long>(snapshot->version), ms, snapshot->elementCount, snapshot->shapeCount);
+
+	publish(snapshot);
+}
+
+// The current scene recorded over new bounds
+void SceneLoader::record(const SkRect& bounds) {
+	SceneSnapshot* snapshot = makeSnapshot(bounds);
+	printf("EMSC:: Scene %llu recorded over %.0f x %.0f\n",
+		static_cast<unsigned long long>(snapshot->version), bounds.width(), bounds.height());
+
+	publish(snapshot);
+}
+
+SceneSnapshot* SceneLoader::makeSnapshot(const SkRect& bounds) {
+	SceneSnapshot* snapshot = new SceneSnapshot();
+	snapshot->version = ++fVersion;
+	snapshot->elementCount = fRenderer.elements().elements.size();
+	snapshot->shapeCount = fRenderer.compiledScene().size();
+	// The picture holds its own references to the paints and blobs, later builds do not touch it
+	snapshot->picture = fRenderer.picture(bounds);
+	fRecordedBounds = bounds;
+	return snapshot;
+}
+
+void SceneLoader::publish(SceneSnapshot* snapshot) {
+	delete fRetired.exchange(nullptr, std::memory_order_acq_rel);
+	// A snapshot the render loop never adopted is superseded
+	delete fPublished.exchange(snapshot, std::memory_order_acq_rel);
+
+	if (fPublish) {
+		fPublish();
+	}
+}
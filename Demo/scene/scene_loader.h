@@ -0,0 +1,106 @@
+#ifndef SCENE_LOADER_H
+#define SCENE_LOADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "include/core/SkFont.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+
+#include "scene_renderer.h"
+
+class SkCanvas;
+
+// One built scene, never modified after it is published
+struct SceneSnapshot {
+	uint64_t version = 0;
+	size_t elementCount = 0;
+	size_t shapeCount = 0;
+	// The scene content without the white background
+	sk_sp<SkPicture> picture;
+};
+
+/*
+ * Builds scenes on a worker thread while the render loop keeps drawing the previous one.
+ * Mapping, compiling (paints, shaders, text blobs, spatial index) and recording the picture
+ * all happen on the loader thread, which then publishes an immutable SceneSnapshot. The render
+ * loop calls update() at a frame boundary to adopt the newest snapshot; that is a single
+ * atomic exchange, it never waits for the loader. Loads requested while the loader is busy
+ * collapse into the newest one. Replaced snapshots are freed on the loader thread.
+ * New bounds, e.g. after a window resize, are recorded into a new snapshot the same way.
+ */
+class SceneLoader {
+public:
+	using PublishCallback = std::function<void()>;
+
+	// bounds is the area recorded into the scene pictures
+	explicit SceneLoader(const SkRect& bounds, const std::string& fontDirectory = "assets/fonts");
+	~SceneLoader();
+
+	SceneLoader(const SceneLoader&) = delete;
+	SceneLoader& operator=(const SceneLoader&) = delete;
+
+	// Runs on the loader thread after every published snapshot, e.g. to wake a sleeping loop.
+	// Set it before the first load.
+	void setPublishCallback(PublishCallback callback) { fPublish = std::move(callback); }
+
+	// Default font of the scene, safe to use on the render thread
+	const SkFont& font() const { return fFont; }
+
+	// Queues scene JSON for the loader. A scene that fails to map keeps the current one.
+	void load(std::string json);
+	// Area recorded into later pictures; the current scene is recorded again over it
+	void setBounds(const SkRect& bounds);
+
+	// Render loop side. Adopts the newest published snapshot and returns true if there was one.
+	bool update();
+	bool hasUpdate() const { return fPublished.load(std::memory_order_acquire) != nullptr; }
+	// nullptr until the first scene is built
+	const SceneSnapshot* snapshot() const { return fCurrent; }
+
+	// Clears to white and draws the current snapshot
+	void draw(SkCanvas* canvas) const;
+
+private:
+	void run();
+	void build(const std::string& json, const SkRect& bounds);
+	void record(const SkRect& bounds);
+	SceneSnapshot* makeSnapshot(const SkRect& bounds);
+	void publish(SceneSnapshot* snapshot);
+
+	// Only used by the loader thread once it runs
+	SceneRenderer fRenderer;
+	uint64_t fVersion = 0;
+	// Bounds the last published snapshot was recorded over
+	SkRect fRecordedBounds = SkRect::MakeEmpty();
+	// Read by both threads, never changed after construction
+	SkFont fFont;
+	PublishCallback fPublish;
+
+	std::mutex fMutex;
+	std::condition_variable fWork;
+	std::string fPendingJson;
+	bool fHasPending = false;
+	SkRect fBounds;
+	bool fBoundsChanged = false;
+	bool fStopping = false;
+
+	// Built but not adopted yet, owned by whoever exchanges it out
+	std::atomic<SceneSnapshot*> fPublished{nullptr};
+	// Replaced by the render loop, waiting for the loader to free it
+	std::atomic<SceneSnapshot*> fRetired{nullptr};
+	// Render loop side
+	SceneSnapshot* fCurrent = nullptr;
+
+	std::thread fThread;
+};
+
+#endif //SCENE_LOADER_H
@@ -0,0 +1,33 @@
+#include "scene_picture.h"
+
+#include <cstdio>
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkPictureRecorder.h"
+
+void ScenePicture::invalidate() {
+	fPicture.reset();
+}
+
+void ScenePicture::draw(SkCanvas* canvas, const SkRect& bounds, const RecordFunction& record) {
+	canvas->drawPicture(this->record(bounds, record));
+}
+
+const sk_sp<SkPicture>& ScenePicture::record(const SkRect& bounds, const RecordFunction& recordFunction) {
+	// A resized view needs a new cull rect, otherwise newly exposed shapes would be culled
+	if (fPicture && fBounds != bounds) {
+		invalidate();
+	}
+
+	if (!fPicture) {
+		printf("EMSC:: Recording scene picture\n");
+		SkRTreeFactory bbhFactory;
+		SkPictureRecorder recorder;
+		recordFunction(recorder.beginRecording(bounds, &bbhFactory));
+		fPicture = recorder.finishRecordingAsPicture();
+		fBounds = bounds;
+		printf("EMSC:: Scene picture recorded with %d operations\n", fPicture->approximateOpCount());
+	}
+
+	return fPicture;
+}
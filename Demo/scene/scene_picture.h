@@ -0,0 +1,36 @@
+#ifndef SCENE_PICTURE_H
+#define SCENE_PICTURE_H
+
+#include <functional>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+
+/*
+ * Retained recording of the static part of the scene.
+ * The draw commands are recorded once into an SkPicture with an R-tree, so replaying it
+ * only visits the operations that intersect the current clip. The recording is kept until
+ * invalidate() is called, which must happen whenever the scene data changes.
+ */
+class ScenePicture {
+public:
+	using RecordFunction = std::function<void(SkCanvas*)>;
+
+	void invalidate();
+	bool isValid() const { return fPicture != nullptr; }
+
+	// Records the scene through `record` if needed, then replays the picture on `canvas`
+	void draw(SkCanvas* canvas, const SkRect& bounds, const RecordFunction& record);
+	// Records the scene through `record` if needed
+	const sk_sp<SkPicture>& record(const SkRect& bounds, const RecordFunction& recordFunction);
+
+	const sk_sp<SkPicture>& picture() const { return fPicture; }
+
+private:
+	sk_sp<SkPicture> fPicture;
+	SkRect fBounds = SkRect::MakeEmpty();
+};
+
+#endif //SCENE_PICTURE_H
@@ -0,0 +1,140 @@
+#include "scene_renderer.h"
+
+#include <fstream>
+#include <mutex>
+#include <utility>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkFontStyle.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+
+#include "../fonts.h"
+#include "../include/struct_mapping/struct_mapping.h"
+
+SceneRenderer::SceneRenderer(const std::string& fontDirectory) {
+	registerMapping();
+
+	fTypefaces.addEmbedded("Karla", SkFontStyle::kNormal_Weight, SkFontStyle::kUpright_Slant,
+		dataKarlaRegular, sizeof(dataKarlaRegular));
+	fTypefaces.addDirectory(fontDirectory);
+	fTypefaces.setDefaultFamily("Karla");
+
+	fFont.setTypeface(fTypefaces.match("Karla", SkFontStyle::kNormal_Weight));
+	fFont.setSize(24);
+}
+
+// struct_mapping keeps its member registrations in process wide tables
+void SceneRenderer::registerMapping() {
+	static std::once_flag registered;
+	std::call_once(registered, [] {
+		// Mapping JSON root
+		struct_mapping::reg(&Elements::elements, "elements");
+
+		// Mapping Shapes properties
+		// A shape without a type is skipped like one of an unknown type
+		struct_mapping::reg(&Shape::type, "type", struct_mapping::Default{ShapeType::Unknown});
+		struct_mapping::reg(&Shape::value, "value");
+		struct_mapping::reg(&Shape::fontSize, "fontSize");
+		struct_mapping::reg(&Shape::fillColor, "fillColor");
+		struct_mapping::reg(&Shape::strokeColor, "strokeColor");
+		struct_mapping::reg(&Shape::strokeWidth, "strokeWidth");
+		struct_mapping::reg(&Shape::letterSpacing, "letterSpacing");
+		struct_mapping::reg(&Shape::fontFamily, "fontFamily");
+		struct_mapping::reg(&Shape::fontWeight, "fontWeight", struct_mapping::Default{FontWeight::Regular});
+		// Mapping objects in Shape struct
+		struct_mapping::reg(&Shape::props, "props");
+		struct_mapping::reg(&Shape::gradient, "gradient");
+
+		// Mapping Properties properties
+		struct_mapping::reg(&Properties::x, "x");
+		struct_mapping::reg(&Properties::y, "y");
+		struct_mapping::reg(&Properties::width, "width");
+		struct_mapping::reg(&Properties::height, "height");
+
+		// Mapping Gradient properties
+		struct_mapping::reg(&Gradient::angle, "angle");
+		struct_mapping::reg(&Gradient::direction, "direction");
+		struct_mapping::reg(&Gradient::type, "type", struct_mapping::Default{GradientType::Unknown});
+		// Mapping collections in Gradient struct
+		struct_mapping::reg(&Gradient::colors, "colors");
+		struct_mapping::reg(&Gradient::offsets, "offsets");
+	});
+}
+
+bool SceneRenderer::load(std::istream& json, std::string* error) {
+	Elements elements;
+	struct_mapping::ElementHashes hashes;
+	try {
+		struct_mapping::map_json_to_struct(elements, json, hashes);
+	} catch (const struct_mapping::StructMappingException& e) {
+		if (error) {
+			*error = e.what();
+		}
+		return false;
+	}
+
+	// The digests equal struct_mapping::hash() of each shape, equal lists compile to the same scene
+	const std::vector<uint64_t>& elementHashes = hashes.of("elements");
+	if (fElementHashes && *fElementHashes == elementHashes) {
+		return true;
+	}
+
+	setElements(std::move(elements));
+	fElementHashes = elementHashes;
+	return true;
+}
+
+bool SceneRenderer::loadFile(const std::string& path, std::string* error) {
+	std::ifstream json(path, std::ios::binary);
+	if (!json) {
+		if (error) {
+			*error = "cannot open " + path;
+		}
+		return false;
+	}
+	return load(json, error);
+}
+
+void SceneRenderer::setElements(Elements elements) {
+	fElements = std::move(elements);
+	fElementHashes.reset();
+	compile();
+}
+
+// Needs the font, text shapes are shaped into blobs here
+void SceneRenderer::compile() {
+	fCompiledScene.build(fElements, fFont, &fTypefaces);
+	fPicture.invalidate();
+}
+
+void SceneRenderer::draw(SkCanvas* canvas, const SkRect& bounds) {
+	canvas->clear(SK_ColorWHITE);
+	canvas->drawPicture(picture(bounds));
+}
+
+const sk_sp<SkPicture>& SceneRenderer::picture(const SkRect& bounds) {
+	return fPicture.record(bounds, [this](SkCanvas* recordingCanvas) {
+		drawContent(recordingCanvas);
+	});
+}
+
+void SceneRenderer::drawContent(SkCanvas* canvas) const {
+	canvas->save();
+
+	canvas->translate(SkIntToScalar(128), SkIntToScalar(128));
+	SkRect rect = SkRect::MakeXYWH(-90.5f, -90.5f, 181.0f, 181.0f);
+	SkPaint paint;
+	paint.setColor(SK_ColorBLUE);
+	canvas->drawRect(rect, paint);
+
+	SkPath path;
+	path.cubicTo(768, 0, -512, 256, 256, 256);
+	paint.setColor(SK_ColorGREEN);
+	canvas->drawPath(path, paint);
+
+	// rendering data from file
+	fCompiledScene.draw(canvas);
+
+	canvas->restore();
+}
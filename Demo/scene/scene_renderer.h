@@ -0,0 +1,67 @@
+#ifndef SCENE_RENDERER_H
+#define SCENE_RENDERER_H
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "include/core/SkFont.h"
+#include "include/core/SkRect.h"
+
+#include "compiled_scene.h"
+#include "scene_data.h"
+#include "scene_picture.h"
+#include "typeface_registry.h"
+
+class SkCanvas;
+
+/*
+ * The scene document: mapped Elements, their compiled form and the fonts they use.
+ * Knows nothing about windows or GL, it draws into whatever canvas it is given, so the same
+ * scene renders on screen, into a raster surface or into a picture. The JSON mapping is
+ * registered once per process, the first time a renderer is created; after that renderers
+ * on different threads can load scenes at the same time.
+ */
+class SceneRenderer {
+public:
+	// Fonts are registered from the embedded Karla face and fontDirectory
+	explicit SceneRenderer(const std::string& fontDirectory = "assets/fonts");
+
+	// Maps scene JSON and compiles it. On error the current scene is kept and, when given,
+	// error describes the problem. A document with the same shapes as the last one loaded is
+	// only mapped, the compiled scene and its picture are kept.
+	bool load(std::istream& json, std::string* error = nullptr);
+	bool loadFile(const std::string& path, std::string* error = nullptr);
+	void setElements(Elements elements);
+
+	const Elements& elements() const { return fElements; }
+	const CompiledScene& compiledScene() const { return fCompiledScene; }
+	const SkFont& font() const { return fFont; }
+	TypefaceRegistry& typefaces() { return fTypefaces; }
+
+	// Clears to white and draws the scene; bounds is the area recorded into the scene picture
+	void draw(SkCanvas* canvas, const SkRect& bounds);
+	// The recorded scene without the white background. Playing it back is thread safe.
+	const sk_sp<SkPicture>& picture(const SkRect& bounds);
+
+private:
+	static void registerMapping();
+
+	void compile();
+	void drawContent(SkCanvas* canvas) const;
+
+	TypefaceRegistry fTypefaces;
+	SkFont fFont;
+
+	Elements fElements;
+	// Digests of the shapes of the last load, taken while mapping; unset after setElements
+	std::optional<std::vector<uint64_t>> fElementHashes;
+	// Render-ready copy of the elements, rebuilt whenever they change
+	CompiledScene fCompiledScene;
+	// Recording of the scene content, replayed until the elements change
+	ScenePicture fPicture;
+};
+
+#endif //SCENE_RENDERER_H
@@ -0,0 +1,220 @@
+#include "shader_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "include/core/SkScalar.h"
+#include "include/effects/SkGradientShader.h"
+
+#include "paint_table.h"
+
+namespace {
+
+// "30%" is 0.3, a plain number is taken as a fraction already
+bool parse_offset(const std::string& value, float* offset) {
+	const char* begin = value.c_str();
+	char* end = nullptr;
+	float number = std::strtof(begin, &end);
+	if (end == begin) {
+		return false;
+	}
+	if (*end == '%') {
+		number /= 100;
+		++end;
+	}
+	if (*end != '\0') {
+		return false;
+	}
+	*offset = std::min(std::max(number, 0.0f), 1.0f);
+	return true;
+}
+
+// CSS linear-gradient directions, "to " is optional. Angles are clockwise from "to top",
+// corners are returned as signs and resolved against the shape size later.
+bool parse_direction(std::string direction, float* angle, int* cornerX, int* cornerY) {
+	if (direction.compare(0, 3, "to ") == 0) {
+		direction.erase(0, 3);
+	}
+
+	*cornerX = 0;
+	*cornerY = 0;
+	if (direction.empty() || direction == "bottom") {
+		*angle = 180;
+	} else if (direction == "top") {
+		*angle = 0;
+	} else if (direction == "right") {
+		*angle = 90;
+	} else if (direction == "left") {
+		*angle = 270;
+	} else if (direction == "top right" || direction == "right top") {
+		*cornerX = 1;
+		*cornerY = -1;
+	} else if (direction == "bottom right" || direction == "right bottom") {
+		*cornerX = 1;
+		*cornerY = 1;
+	} else if (direction == "bottom left" || direction == "left bottom") {
+		*cornerX = -1;
+		*cornerY = 1;
+	} else if (direction == "top left" || direction == "left top") {
+		*cornerX = -1;
+		*cornerY = -1;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+std::string gradient_key(const Gradient& gradient) {
+	std::string key = std::to_string(static_cast<int>(gradient.type)) + '|' + std::to_string(gradient.angle) + '|' + gradient.direction;
+	for (const std::string& color : gradient.colors) {
+		key += '|' + color;
+	}
+	key += '#';
+	for (const std::string& offset : gradient.offsets) {
+		key += '|' + offset;
+	}
+	return key;
+}
+
+} // namespace
+
+ShaderCache::ShaderCache(size_t capacity)
+	: fCapacity(capacity) {
+}
+
+size_t ShaderCache::ShaderKeyHash::operator()(const ShaderKey& key) const {
+	size_t hash = std::hash<uint32_t>()(key.gradient);
+	hash = hash * 31 + std::hash<float>()(key.width);
+	hash = hash * 31 + std::hash<float>()(key.height);
+	return hash;
+}
+
+void ShaderCache::setCapacity(size_t capacity) {
+	fCapacity = capacity;
+	trim();
+}
+
+void ShaderCache::clear() {
+	fGradients.clear();
+	fGradientIndex.clear();
+	fShaders.clear();
+	fEntries.clear();
+}
+
+sk_sp<SkShader> ShaderCache::get(const Gradient& gradient, float width, float height) {
+	if (gradient.type == GradientType::Unknown || gradient.colors.empty() || !(width > 0) || !(height > 0)) {
+		return nullptr;
+	}
+
+	uint32_t index = parse(gradient);
+	if (index == kInvalidGradient) {
+		return nullptr;
+	}
+
+	ShaderKey key{index, width, height};
+	auto it = fShaders.find(key);
+	if (it != fShaders.end()) {
+		fEntries.splice(fEntries.begin(), fEntries, it->second);
+		return it->second->shader;
+	}
+
+	sk_sp<SkShader> shader = make(fGradients[index], width, height);
+	fEntries.push_front({key, shader});
+	fShaders.emplace(key, fEntries.begin());
+	trim();
+	return shader;
+}
+
+void ShaderCache::trim() {
+	while (fEntries.size() > fCapacity) {
+		fShaders.erase(fEntries.back().key);
+		fEntries.pop_back();
+	}
+}
+
+uint32_t ShaderCache::parse(const Gradient& gradient) {
+	std::string key = gradient_key(gradient);
+	if (fGradientIndex.size() >= fCapacity && fGradientIndex.find(key) == fGradientIndex.end()) {
+		// Shader keys refer to gradients by index, so both tables start over
+		clear();
+	}
+
+	auto [it, inserted] = fGradientIndex.try_emplace(std::move(key), kInvalidGradient);
+	if (!inserted) {
+		return it->second;
+	}
+
+	ParsedGradient parsed;
+	parsed.type = gradient.type;
+	parsed.angle = static_cast<float>(gradient.angle);
+	parsed.cornerX = 0;
+	parsed.cornerY = 0;
+
+	// A negative angle means the direction keyword is used instead
+	if (gradient.angle < 0 && !parse_direction(gradient.direction, &parsed.angle, &parsed.cornerX, &parsed.cornerY)) {
+		printf("EMSC:: Unknown gradient direction '%s', using 'to bottom'\n", gradient.direction.c_str());
+		parsed.angle = 180;
+	}
+
+	for (const std::string& color : gradient.colors) {
+		auto value = PaintTable::parseColor(color);
+		if (!value) {
+			printf("EMSC:: Unknown gradient color '%s', gradient is not painted\n", color.c_str());
+			return kInvalidGradient;
+		}
+		parsed.colors.push_back(*value);
+	}
+
+	// Offsets are optional, without a complete valid list the colors are spread evenly
+	if (gradient.offsets.size() == gradient.colors.size()) {
+		for (const std::string& offset : gradient.offsets) {
+			float value;
+			if (!parse_offset(offset, &value)) {
+				printf("EMSC:: Bad gradient offset '%s', spreading colors evenly\n", offset.c_str());
+				parsed.positions.clear();
+				break;
+			}
+			parsed.positions.push_back(parsed.positions.empty() ? value : std::max(value, parsed.positions.back()));
+		}
+	}
+
+	fGradients.push_back(std::move(parsed));
+	it->second = static_cast<uint32_t>(fGradients.size() - 1);
+	return it->second;
+}
+
+sk_sp<SkShader> ShaderCache::make(const ParsedGradient& gradient, float width, float height) const {
+	const SkPoint center = SkPoint::Make(width / 2, height / 2);
+	const SkScalar* positions = gradient.positions.empty() ? nullptr : gradient.positions.data();
+	const int count = static_cast<int>(gradient.colors.size());
+
+	if (gradient.type == GradientType::Radial) {
+		// CSS default: circle reaching the farthest corner
+		return SkGradientShader::MakeRadial(center, std::hypot(width, height) / 2,
+			gradient.colors.data(), positions, count, SkTileMode::kClamp);
+	}
+
+	float dx;
+	float dy;
+	if (gradient.cornerX != 0) {
+		// Perpendicular to the diagonal that does not touch the target corner
+		float length = std::hypot(width, height);
+		dx = gradient.cornerX * height / length;
+		dy = gradient.cornerY * width / length;
+	} else {
+		float radians = SkDegreesToRadians(gradient.angle);
+		dx = std::sin(radians);
+		dy = -std::cos(radians);
+	}
+
+	// Gradient line through the center, long enough for the corners to get the end colors
+	float halfLength = (std::abs(width * dx) + std::abs(height * dy)) / 2;
+	SkPoint points[2] = {
+		SkPoint::Make(center.fX - dx * halfLength, center.fY - dy * halfLength),
+		SkPoint::Make(center.fX + dx * halfLength, center.fY + dy * halfLength),
+	};
+	return SkGradientShader::MakeLinear(points, gradient.colors.data(), positions, count, SkTileMode::kClamp);
+}
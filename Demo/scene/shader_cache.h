@@ -0,0 +1,84 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "include/core/SkColor.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkSize.h"
+
+#include "scene_data.h"
+
+/*
+ * Gradient shaders built from Shape::gradient.
+ * The color and offset strings of each distinct gradient are parsed once, and shaders are
+ * deduplicated by gradient and shape size. Shaders are defined in shape-local coordinates,
+ * (0, 0) being the top left corner of the shape, so every shape of the same size and style
+ * shares one shader and is drawn translated to its position.
+ * Shaders are a bounded LRU, like the text blobs; shapes holding a shader keep it alive after
+ * it is evicted. Once capacity distinct gradients have been parsed, the cache starts over.
+ */
+class ShaderCache {
+public:
+	explicit ShaderCache(size_t capacity = 1024);
+
+	// Returns nullptr when the gradient has no valid colors or the size is empty
+	sk_sp<SkShader> get(const Gradient& gradient, float width, float height);
+
+	size_t size() const { return fEntries.size(); }
+	size_t capacity() const { return fCapacity; }
+	void setCapacity(size_t capacity);
+	void clear();
+
+private:
+	// Gradient with its strings parsed. Linear gradients follow CSS: angle is in degrees
+	// clockwise from "to top", or a corner direction that depends on the aspect ratio.
+	struct ParsedGradient {
+		GradientType type;
+		float angle;
+		int cornerX;
+		int cornerY;
+		std::vector<SkColor> colors;
+		std::vector<float> positions;
+	};
+
+	struct ShaderKey {
+		uint32_t gradient;
+		float width;
+		float height;
+
+		bool operator==(const ShaderKey& other) const {
+			return gradient == other.gradient && width == other.width && height == other.height;
+		}
+	};
+
+	struct ShaderKeyHash {
+		size_t operator()(const ShaderKey& key) const;
+	};
+
+	struct Entry {
+		ShaderKey key;
+		sk_sp<SkShader> shader;
+	};
+
+	static const uint32_t kInvalidGradient = UINT32_MAX;
+
+	uint32_t parse(const Gradient& gradient);
+	sk_sp<SkShader> make(const ParsedGradient& gradient, float width, float height) const;
+	void trim();
+
+	size_t fCapacity;
+	std::vector<ParsedGradient> fGradients;
+	// Gradient members as written in the scene -> index in fGradients or kInvalidGradient
+	std::unordered_map<std::string, uint32_t> fGradientIndex;
+	// Most recently used first
+	std::list<Entry> fEntries;
+	std::unordered_map<ShaderKey, std::list<Entry>::iterator, ShaderKeyHash> fShaders;
+};
+
+#endif //SHADER_CACHE_H
@@ -0,0 +1,146 @@
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+SkRect union_of(const SkRect* begin, const SkRect* end) {
+	SkRect result = SkRect::MakeEmpty();
+	for (const SkRect* it = begin; it != end; ++it) {
+		result.join(*it);
+	}
+	return result;
+}
+
+} // namespace
+
+void SpatialIndex::clear() {
+	fBounds.clear();
+	fStale.clear();
+	fOverflow.clear();
+	fEntries.clear();
+	fLevels.clear();
+}
+
+void SpatialIndex::build(const std::vector<SkRect>& bounds) {
+	fBounds = bounds;
+	pack();
+}
+
+void SpatialIndex::insert(uint32_t id, const SkRect& bounds) {
+	if (id < fBounds.size()) {
+		update(id, bounds);
+		return;
+	}
+
+	fBounds.push_back(bounds);
+	fStale.push_back(false);
+	markEdited(id);
+}
+
+void SpatialIndex::update(uint32_t id, const SkRect& bounds) {
+	fBounds[id] = bounds;
+	markEdited(id);
+}
+
+void SpatialIndex::remove(uint32_t id) {
+	update(id, SkRect::MakeEmpty());
+}
+
+void SpatialIndex::markEdited(uint32_t id) {
+	if (!fStale[id]) {
+		fStale[id] = true;
+		fOverflow.push_back(id);
+	}
+
+	// Linear scans stay cheap while the overflow is small compared to the tree
+	if (fOverflow.size() > std::max<size_t>(64, fBounds.size() / 8)) {
+		pack();
+	}
+}
+
+void SpatialIndex::pack() {
+	fStale.assign(fBounds.size(), false);
+	fOverflow.clear();
+	fEntries.clear();
+	fLevels.clear();
+
+	fEntries.reserve(fBounds.size());
+	for (uint32_t id = 0; id < fBounds.size(); ++id) {
+		if (!fBounds[id].isEmpty()) {
+			fEntries.push_back({fBounds[id], id});
+		}
+	}
+	if (fEntries.empty()) {
+		return;
+	}
+
+	// Sort-tile-recursive: vertical slices by center x, each slice sorted by center y
+	const size_t leafCount = (fEntries.size() + kNodeSize - 1) / kNodeSize;
+	const size_t sliceCount = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(leafCount))));
+	const size_t sliceSize = sliceCount * kNodeSize;
+
+	std::sort(fEntries.begin(), fEntries.end(), [](const Entry& a, const Entry& b) {
+		return a.bounds.centerX() < b.bounds.centerX();
+	});
+	for (size_t start = 0; start < fEntries.size(); start += sliceSize) {
+		auto end = fEntries.begin() + std::min(start + sliceSize, fEntries.size());
+		std::sort(fEntries.begin() + start, end, [](const Entry& a, const Entry& b) {
+			return a.bounds.centerY() < b.bounds.centerY();
+		});
+	}
+
+	std::vector<SkRect> childBounds(fEntries.size());
+	std::transform(fEntries.begin(), fEntries.end(), childBounds.begin(), [](const Entry& entry) { return entry.bounds; });
+
+	// Each level groups kNodeSize consecutive children until a single root remains
+	do {
+		std::vector<Node> level;
+		level.reserve((childBounds.size() + kNodeSize - 1) / kNodeSize);
+		for (size_t first = 0; first < childBounds.size(); first += kNodeSize) {
+			uint32_t count = static_cast<uint32_t>(std::min<size_t>(kNodeSize, childBounds.size() - first));
+			level.push_back({union_of(&childBounds[first], &childBounds[first] + count), static_cast<uint32_t>(first), count});
+		}
+
+		childBounds.resize(level.size());
+		std::transform(level.begin(), level.end(), childBounds.begin(), [](const Node& node) { return node.bounds; });
+		fLevels.push_back(std::move(level));
+	} while (fLevels.back().size() > 1);
+}
+
+void SpatialIndex::query(const SkRect& area, std::vector<uint32_t>* results) const {
+	results->clear();
+
+	if (!fLevels.empty()) {
+		queryNode(fLevels.size() - 1, fLevels.back().front(), area, results);
+	}
+	for (uint32_t id : fOverflow) {
+		if (SkRect::Intersects(fBounds[id], area)) {
+			results->push_back(id);
+		}
+	}
+
+	std::sort(results->begin(), results->end());
+}
+
+void SpatialIndex::queryNode(size_t level, const Node& node, const SkRect& area, std::vector<uint32_t>* results) const {
+	if (!SkRect::Intersects(node.bounds, area)) {
+		return;
+	}
+
+	if (level == 0) {
+		for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+			const Entry& entry = fEntries[i];
+			if (!fStale[entry.id] && SkRect::Intersects(entry.bounds, area)) {
+				results->push_back(entry.id);
+			}
+		}
+		return;
+	}
+
+	const std::vector<Node>& children = fLevels[level - 1];
+	for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+		queryNode(level - 1, children[i], area, results);
+	}
+}
@@ -0,0 +1,61 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <cstdint>
+#include <vector>
+
+#include "include/core/SkRect.h"
+
+/*
+ * Packed R-tree over element bounds, ids being the element positions in draw order.
+ * The tree is bulk loaded with sort-tile-recursive packing. Edits do not touch it: an edited
+ * element is marked stale in the tree and kept in a small overflow list that queries scan
+ * linearly, and the tree is repacked once that list grows past a fraction of the elements.
+ */
+class SpatialIndex {
+public:
+	void build(const std::vector<SkRect>& bounds);
+	void clear();
+
+	// id must be the next id (size()) or an existing one
+	void insert(uint32_t id, const SkRect& bounds);
+	void update(uint32_t id, const SkRect& bounds);
+	void remove(uint32_t id);
+
+	// Appends the ids of the elements intersecting area to results, in ascending order.
+	// results is cleared first; reusing it across frames avoids allocations.
+	void query(const SkRect& area, std::vector<uint32_t>* results) const;
+
+	size_t size() const { return fBounds.size(); }
+	const SkRect& bounds(uint32_t id) const { return fBounds[id]; }
+
+private:
+	static constexpr uint32_t kNodeSize = 16;
+
+	struct Entry {
+		SkRect bounds;
+		uint32_t id;
+	};
+
+	// Covers children [first, first + count) of the level below, or of fEntries for level 0
+	struct Node {
+		SkRect bounds;
+		uint32_t first;
+		uint32_t count;
+	};
+
+	void pack();
+	void queryNode(size_t level, const Node& node, const SkRect& area, std::vector<uint32_t>* results) const;
+	void markEdited(uint32_t id);
+
+	// Current bounds by id; removed elements are empty
+	std::vector<SkRect> fBounds;
+	// Set for ids whose tree entry is out of date
+	std::vector<bool> fStale;
+	std::vector<uint32_t> fOverflow;
+
+	std::vector<Entry> fEntries;
+	std::vector<std::vector<Node>> fLevels;
+};
+
+#endif //SPATIAL_INDEX_H
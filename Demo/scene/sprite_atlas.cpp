@@ -0,0 +1,124 @@
+#include "sprite_atlas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkSurface.h"
+
+namespace {
+
+// Rounded up to quarter steps, so small zoom changes reuse the atlas
+float atlas_scale(const SkCanvas* canvas) {
+	float scale = canvas->getTotalMatrix().getMaxScale();
+	if (!(scale > 0)) {
+		scale = 1;
+	}
+	return std::ceil(scale * 4) / 4;
+}
+
+} // namespace
+
+int SpriteAtlas::add(const SkRect& bounds, DrawFunction draw) {
+	fSprites.push_back({bounds, std::move(draw), SkIRect::MakeEmpty()});
+	fImage.reset();
+	return static_cast<int>(fSprites.size()) - 1;
+}
+
+void SpriteAtlas::render(SkCanvas* canvas, float scale) {
+	fImage.reset();
+	fScale = scale;
+	if (fSprites.empty()) {
+		return;
+	}
+
+	// Shelf packing, tallest sprites first, into rows about as wide as the atlas is tall
+	std::vector<size_t> order(fSprites.size());
+	std::iota(order.begin(), order.end(), 0);
+	int64_t area = 0;
+	int maxWidth = 0;
+	for (Sprite& sprite : fSprites) {
+		int width = static_cast<int>(std::ceil(sprite.bounds.width() * scale));
+		int height = static_cast<int>(std::ceil(sprite.bounds.height() * scale));
+		sprite.slot = SkIRect::MakeWH(width, height);
+		area += int64_t(width + kPadding) * (height + kPadding);
+		maxWidth = std::max(maxWidth, width + kPadding);
+	}
+	std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+		return fSprites[a].slot.height() > fSprites[b].slot.height();
+	});
+
+	const int rowLimit = std::max(maxWidth, static_cast<int>(std::ceil(std::sqrt(double(area)))));
+	int x = 0;
+	int y = 0;
+	int rowHeight = 0;
+	int atlasWidth = 0;
+	for (size_t index : order) {
+		SkIRect& slot = fSprites[index].slot;
+		if (x + slot.width() + kPadding > rowLimit) {
+			x = 0;
+			y += rowHeight;
+			rowHeight = 0;
+		}
+		slot.offset(x, y);
+		x += slot.width() + kPadding;
+		rowHeight = std::max(rowHeight, slot.height() + kPadding);
+		atlasWidth = std::max(atlasWidth, x);
+	}
+
+	SkImageInfo info = SkImageInfo::MakeN32Premul(atlasWidth, y + rowHeight);
+	sk_sp<SkSurface> surface = canvas->makeSurface(info);
+	if (!surface) {
+		surface = SkSurface::MakeRaster(info);
+	}
+	if (!surface) {
+		return;
+	}
+
+	SkCanvas* atlasCanvas = surface->getCanvas();
+	atlasCanvas->clear(SK_ColorTRANSPARENT);
+	for (const Sprite& sprite : fSprites) {
+		atlasCanvas->save();
+		atlasCanvas->translate(static_cast<float>(sprite.slot.fLeft), static_cast<float>(sprite.slot.fTop));
+		atlasCanvas->scale(scale, scale);
+		atlasCanvas->translate(-sprite.bounds.fLeft, -sprite.bounds.fTop);
+		atlasCanvas->clipRect(sprite.bounds);
+		sprite.draw(atlasCanvas);
+		atlasCanvas->restore();
+	}
+
+	fImage = surface->makeImageSnapshot();
+}
+
+void SpriteAtlas::draw(SkCanvas* canvas, const int sprites[], const SkRSXform xforms[], int count, const SkPaint* paint) {
+	float scale = atlas_scale(canvas);
+	if (!fImage || scale != fScale) {
+		render(canvas, scale);
+	}
+	if (!fImage) {
+		return;
+	}
+
+	// drawAtlas places the top left of each slot at the xform origin, one atlas pixel per unit
+	fXforms.resize(count);
+	fTex.resize(count);
+	for (int i = 0; i < count; ++i) {
+		const Sprite& sprite = fSprites[sprites[i]];
+		const SkRSXform& xform = xforms[i];
+		float left = sprite.bounds.fLeft;
+		float top = sprite.bounds.fTop;
+		fXforms[i] = SkRSXform::Make(xform.fSCos / fScale, xform.fSSin / fScale,
+			xform.fTx + xform.fSCos * left - xform.fSSin * top,
+			xform.fTy + xform.fSSin * left + xform.fSCos * top);
+		fTex[i] = SkRect::Make(sprite.slot);
+	}
+
+	SkPaint filtered;
+	filtered.setFilterQuality(kLow_SkFilterQuality);
+	canvas->drawAtlas(fImage.get(), fXforms.data(), fTex.data(), nullptr, count, SkBlendMode::kSrcOver,
+		nullptr, paint ? paint : &filtered);
+}
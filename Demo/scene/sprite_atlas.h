@@ -0,0 +1,63 @@
+#ifndef SPRITE_ATLAS_H
+#define SPRITE_ATLAS_H
+
+#include <functional>
+#include <vector>
+
+#include "include/core/SkImage.h"
+#include "include/core/SkRSXform.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+
+class SkCanvas;
+class SkPaint;
+
+/*
+ * Pre-rendered sprites packed into one shared image and drawn with drawAtlas.
+ * Each sprite is described by the local bounds of its content and a function drawing it,
+ * and only gets that many pixels in the atlas. The atlas is rendered lazily at the scale of
+ * the canvas it is drawn into and rendered again when that scale changes, so sprites stay
+ * sharp on high density displays without being kept at window size.
+ */
+class SpriteAtlas {
+public:
+	using DrawFunction = std::function<void(SkCanvas*)>;
+
+	// Returns the sprite id; `draw` must stay inside `bounds`
+	int add(const SkRect& bounds, DrawFunction draw);
+	const SkRect& bounds(int sprite) const { return fSprites[sprite].bounds; }
+
+	// Renders the sprites again on the next draw
+	void invalidate() { fImage.reset(); }
+
+	// Each xform maps the local space of its sprite into the canvas
+	void draw(SkCanvas* canvas, const int sprites[], const SkRSXform xforms[], int count, const SkPaint* paint = nullptr);
+	void draw(SkCanvas* canvas, int sprite, const SkRSXform& xform, const SkPaint* paint = nullptr) {
+		draw(canvas, &sprite, &xform, 1, paint);
+	}
+
+	const sk_sp<SkImage>& image() const { return fImage; }
+	float scale() const { return fScale; }
+
+private:
+	// Transparent pixels between sprites, so filtering never picks up a neighbour
+	static constexpr int kPadding = 2;
+
+	struct Sprite {
+		SkRect bounds;
+		DrawFunction draw;
+		SkIRect slot;
+	};
+
+	void render(SkCanvas* canvas, float scale);
+
+	std::vector<Sprite> fSprites;
+	sk_sp<SkImage> fImage;
+	float fScale = 0;
+
+	// Per draw scratch space
+	std::vector<SkRSXform> fXforms;
+	std::vector<SkRect> fTex;
+};
+
+#endif //SPRITE_ATLAS_H
@@ -0,0 +1,145 @@
+#include "surface_pool.h"
+
+#include <functional>
+#include <new>
+#include <utility>
+
+SurfacePool::SurfacePool(size_t byteBudget)
+	: fBudget(byteBudget) {
+}
+
+SurfacePool::~SurfacePool() {
+	purge();
+}
+
+SurfacePool& SurfacePool::Default() {
+	// Leaked, surfaces may be released during static destruction
+	static SurfacePool* pool = new SurfacePool();
+	return *pool;
+}
+
+size_t SurfacePool::KeyHash::operator()(const Key& key) const {
+	size_t hash = std::hash<int>()(key.width);
+	hash = hash * 31 + std::hash<int>()(key.height);
+	hash = hash * 31 + std::hash<int>()(static_cast<int>(key.colorType));
+	hash = hash * 31 + std::hash<int>()(static_cast<int>(key.alphaType));
+	return hash;
+}
+
+sk_sp<SkSurface> SurfacePool::makeSurface(const SkImageInfo& info) {
+	if (info.isEmpty() || info.colorType() == kUnknown_SkColorType) {
+		return nullptr;
+	}
+
+	Key key{info.width(), info.height(), info.colorType(), info.alphaType()};
+	std::unique_ptr<Buffer> buffer;
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		auto it = fIndex.find(key);
+		if (it != fIndex.end()) {
+			++fHits;
+			buffer = std::move(*it->second);
+			fIdle.erase(it->second);
+			fIndex.erase(it);
+			fIdleBytes -= buffer->bytes;
+		} else {
+			++fMisses;
+		}
+	}
+
+	if (!buffer) {
+		size_t bytes = info.computeMinByteSize();
+		if (SkImageInfo::ByteSizeOverflowed(bytes)) {
+			return nullptr;
+		}
+		// Large surfaces can fail to allocate, that is a failed render and not a crash
+		std::unique_ptr<char[]> pixels(new (std::nothrow) char[bytes]);
+		if (!pixels) {
+			return nullptr;
+		}
+		buffer.reset(new Buffer{this, key, bytes, std::move(pixels)});
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fUsedBytes += buffer->bytes;
+	}
+
+	Buffer* context = buffer.get();
+	sk_sp<SkSurface> surface = SkSurface::MakeRasterDirectReleaseProc(info, context->pixels.get(), info.minRowBytes(), release, context);
+	if (surface) {
+		buffer.release();
+	} else {
+		// Skia does not call the release proc for surfaces it could not make
+		recycle(std::move(buffer));
+	}
+	return surface;
+}
+
+void SurfacePool::release(void*, void* context) {
+	std::unique_ptr<Buffer> buffer(static_cast<Buffer*>(context));
+	buffer->pool->recycle(std::move(buffer));
+}
+
+void SurfacePool::recycle(std::unique_ptr<Buffer> buffer) {
+	std::lock_guard<std::mutex> lock(fMutex);
+	fUsedBytes -= buffer->bytes;
+	fIdleBytes += buffer->bytes;
+	Key key = buffer->key;
+	fIdle.push_front(std::move(buffer));
+	fIndex.emplace(key, fIdle.begin());
+	trim();
+}
+
+size_t SurfacePool::budget() const {
+	std::lock_guard<std::mutex> lock(fMutex);
+	return fBudget;
+}
+
+void SurfacePool::setBudget(size_t byteBudget) {
+	std::lock_guard<std::mutex> lock(fMutex);
+	fBudget = byteBudget;
+	trim();
+}
+
+void SurfacePool::purge() {
+	std::lock_guard<std::mutex> lock(fMutex);
+	fIndex.clear();
+	fIdle.clear();
+	fIdleBytes = 0;
+}
+
+void SurfacePool::trim() {
+	while (fIdleBytes > fBudget) {
+		auto last = std::prev(fIdle.end());
+		auto range = fIndex.equal_range((*last)->key);
+		for (auto it = range.first; it != range.second; ++it) {
+			if (it->second == last) {
+				fIndex.erase(it);
+				break;
+			}
+		}
+		fIdleBytes -= (*last)->bytes;
+		fIdle.erase(last);
+	}
+}
+
+size_t SurfacePool::idleBytes() const {
+	std::lock_guard<std::mutex> lock(fMutex);
+	return fIdleBytes;
+}
+
+size_t SurfacePool::usedBytes() const {
+	std::lock_guard<std::mutex> lock(fMutex);
+	return fUsedBytes;
+}
+
+uint64_t SurfacePool::hits() const {
+	std::lock_guard<std::mutex> lock(fMutex);
+	return fHits;
+}
+
+uint64_t SurfacePool::misses() const {
+	std::lock_guard<std::mutex> lock(fMutex);
+	return fMisses;
+}
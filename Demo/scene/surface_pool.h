@@ -0,0 +1,87 @@
+#ifndef SURFACE_POOL_H
+#define SURFACE_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSurface.h"
+
+/*
+ * Reusable pixel buffers for offscreen raster surfaces.
+ * Buffers are keyed by (width, height, color type, alpha type) and wrapped with
+ * SkSurface::MakeRasterDirect, so rendering the same sizes again allocates no pixel memory.
+ * When the last reference to a surface goes away its buffer returns to the pool; idle buffers
+ * above the byte budget are freed least recently used first. The pool is thread safe and must
+ * outlive the surfaces it made, Default() is never destroyed.
+ */
+class SurfacePool {
+public:
+	explicit SurfacePool(size_t byteBudget = 256 * 1024 * 1024);
+	~SurfacePool();
+
+	SurfacePool(const SurfacePool&) = delete;
+	SurfacePool& operator=(const SurfacePool&) = delete;
+
+	static SurfacePool& Default();
+
+	// The pixels are not cleared. Returns nullptr when the info is empty or invalid, or when the
+	// pixels cannot be allocated.
+	sk_sp<SkSurface> makeSurface(const SkImageInfo& info);
+
+	// Budget for idle buffers, buffers in use are never freed
+	size_t budget() const;
+	void setBudget(size_t byteBudget);
+	void purge();
+
+	size_t idleBytes() const;
+	size_t usedBytes() const;
+	uint64_t hits() const;
+	uint64_t misses() const;
+
+private:
+	struct Key {
+		int width;
+		int height;
+		SkColorType colorType;
+		SkAlphaType alphaType;
+
+		bool operator==(const Key& other) const {
+			return width == other.width && height == other.height
+				&& colorType == other.colorType && alphaType == other.alphaType;
+		}
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const;
+	};
+
+	// Travels with the surface as its release context
+	struct Buffer {
+		SurfacePool* pool;
+		Key key;
+		size_t bytes;
+		std::unique_ptr<char[]> pixels;
+	};
+
+	static void release(void* pixels, void* context);
+	void recycle(std::unique_ptr<Buffer> buffer);
+	void trim();
+
+	mutable std::mutex fMutex;
+	size_t fBudget;
+	size_t fIdleBytes = 0;
+	size_t fUsedBytes = 0;
+	uint64_t fHits = 0;
+	uint64_t fMisses = 0;
+	// Idle buffers, most recently released first
+	std::list<std::unique_ptr<Buffer>> fIdle;
+	std::unordered_multimap<Key, std::list<std::unique_ptr<Buffer>>::iterator, KeyHash> fIndex;
+};
+
+#endif //SURFACE_POOL_H
@@ -0,0 +1,82 @@
+#include "text_blob_cache.h"
+
+#include <functional>
+#include <vector>
+
+#include "include/core/SkTypeface.h"
+
+TextBlobCache::TextBlobCache(size_t capacity)
+	: fCapacity(capacity) {
+}
+
+size_t TextBlobCache::KeyHash::operator()(const Key& key) const {
+	size_t hash = std::hash<std::string>()(key.text);
+	hash = hash * 31 + std::hash<SkTypefaceID>()(key.typeface);
+	hash = hash * 31 + std::hash<float>()(key.size);
+	hash = hash * 31 + std::hash<float>()(key.letterSpacing);
+	return hash;
+}
+
+void TextBlobCache::setCapacity(size_t capacity) {
+	fCapacity = capacity;
+	trim();
+}
+
+void TextBlobCache::clear() {
+	fIndex.clear();
+	fEntries.clear();
+}
+
+sk_sp<SkTextBlob> TextBlobCache::get(const std::string& text, const SkFont& font, float letterSpacing) {
+	if (text.empty()) {
+		return nullptr;
+	}
+
+	SkTypeface* typeface = font.getTypeface();
+	Key key{text, typeface ? typeface->uniqueID() : 0, font.getSize(), letterSpacing};
+
+	auto it = fIndex.find(key);
+	if (it != fIndex.end()) {
+		++fHits;
+		fEntries.splice(fEntries.begin(), fEntries, it->second);
+		return it->second->blob;
+	}
+
+	++fMisses;
+	sk_sp<SkTextBlob> blob = make(text, font, letterSpacing);
+	fEntries.push_front({std::move(key), blob});
+	fIndex.emplace(fEntries.front().key, fEntries.begin());
+	trim();
+
+	return blob;
+}
+
+void TextBlobCache::trim() {
+	while (fEntries.size() > fCapacity) {
+		fIndex.erase(fEntries.back().key);
+		fEntries.pop_back();
+	}
+}
+
+sk_sp<SkTextBlob> TextBlobCache::make(const std::string& text, const SkFont& font, float letterSpacing) {
+	int count = font.countText(text.data(), text.size(), SkTextEncoding::kUTF8);
+	if (count <= 0) {
+		return nullptr;
+	}
+
+	SkTextBlobBuilder builder;
+	const SkTextBlobBuilder::RunBuffer& run = builder.allocRunPos(font, count);
+	font.textToGlyphs(text.data(), text.size(), SkTextEncoding::kUTF8, run.glyphs, count);
+
+	std::vector<SkScalar> widths(count);
+	font.getWidths(run.glyphs, count, widths.data());
+
+	SkPoint* positions = run.points();
+	SkScalar x = 0;
+	for (int i = 0; i < count; ++i) {
+		positions[i] = SkPoint::Make(x, 0);
+		x += widths[i] + letterSpacing;
+	}
+
+	return builder.make();
+}
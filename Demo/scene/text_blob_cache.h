@@ -0,0 +1,67 @@
+#ifndef TEXT_BLOB_CACHE_H
+#define TEXT_BLOB_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "include/core/SkFont.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkTextBlob.h"
+
+/*
+ * Shaped text, converted to glyphs once and kept as SkTextBlobs.
+ * Blobs are keyed by (text, typeface, size, letter spacing) and positioned from (0, 0) on the
+ * baseline, so equal labels anywhere in the scene share one blob. The cache is a bounded LRU;
+ * evicting an entry only drops the cache reference, shapes holding the blob keep it alive.
+ */
+class TextBlobCache {
+public:
+	explicit TextBlobCache(size_t capacity = 4096);
+
+	// letterSpacing is added after every glyph. Returns nullptr for empty text.
+	sk_sp<SkTextBlob> get(const std::string& text, const SkFont& font, float letterSpacing);
+
+	size_t size() const { return fEntries.size(); }
+	size_t capacity() const { return fCapacity; }
+	void setCapacity(size_t capacity);
+	void clear();
+
+	uint64_t hits() const { return fHits; }
+	uint64_t misses() const { return fMisses; }
+
+private:
+	struct Key {
+		std::string text;
+		SkTypefaceID typeface;
+		float size;
+		float letterSpacing;
+
+		bool operator==(const Key& other) const {
+			return typeface == other.typeface && size == other.size
+				&& letterSpacing == other.letterSpacing && text == other.text;
+		}
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const;
+	};
+
+	struct Entry {
+		Key key;
+		sk_sp<SkTextBlob> blob;
+	};
+
+	static sk_sp<SkTextBlob> make(const std::string& text, const SkFont& font, float letterSpacing);
+	void trim();
+
+	size_t fCapacity;
+	// Most recently used first
+	std::list<Entry> fEntries;
+	std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> fIndex;
+	uint64_t fHits = 0;
+	uint64_t fMisses = 0;
+};
+
+#endif //TEXT_BLOB_CACHE_H
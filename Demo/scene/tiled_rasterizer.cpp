@@ -0,0 +1,58 @@
+#include "tiled_rasterizer.h"
+
+#include <algorithm>
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkSurface.h"
+
+#include "surface_pool.h"
+
+void TiledRasterizer::render(const SkPicture& picture, float scale, const SkPixmap& dst) {
+	renderArea(picture, scale, 0, 0, dst);
+}
+
+void TiledRasterizer::renderBands(const SkPicture& picture, float scale, int width, int height, const BandFunction& band) {
+	const int bandHeight = std::min(height, std::max(1, fOptions.tileHeight));
+	sk_sp<SkSurface> surface = SurfacePool::Default().makeSurface(SkImageInfo::MakeN32Premul(width, bandHeight));
+	SkPixmap pixels;
+	if (!surface || !surface->peekPixels(&pixels)) {
+		return;
+	}
+
+	for (int top = 0; top < height; top += bandHeight) {
+		SkPixmap pixmap(pixels.info().makeWH(width, std::min(bandHeight, height - top)), pixels.addr(), pixels.rowBytes());
+		renderArea(picture, scale, 0, top, pixmap);
+		band(top, pixmap);
+	}
+}
+
+void TiledRasterizer::renderArea(const SkPicture& picture, float scale, int left, int top, const SkPixmap& dst) {
+	const int tileWidth = std::max(1, fOptions.tileWidth);
+	const int tileHeight = std::max(1, fOptions.tileHeight);
+	const SkColor background = fOptions.background;
+
+	for (int y = 0; y < dst.height(); y += tileHeight) {
+		for (int x = 0; x < dst.width(); x += tileWidth) {
+			SkIRect tile = SkIRect::MakeXYWH(x, y, std::min(tileWidth, dst.width() - x), std::min(tileHeight, dst.height() - y));
+			fPool.submit([&picture, &dst, tile, scale, background, left, top] {
+				SkPixmap pixels;
+				if (!dst.extractSubset(&pixels, tile)) {
+					return;
+				}
+				sk_sp<SkSurface> surface = SkSurface::MakeRasterDirect(pixels.info(), pixels.writable_addr(), pixels.rowBytes());
+				if (!surface) {
+					return;
+				}
+
+				SkCanvas* canvas = surface->getCanvas();
+				canvas->clear(background);
+				canvas->translate(-static_cast<float>(left + tile.fLeft), -static_cast<float>(top + tile.fTop));
+				canvas->scale(scale, scale);
+				canvas->drawPicture(&picture);
+			});
+		}
+	}
+
+	fPool.wait();
+}
@@ -0,0 +1,51 @@
+#ifndef TILED_RASTERIZER_H
+#define TILED_RASTERIZER_H
+
+#include <functional>
+
+#include "include/core/SkColor.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPixmap.h"
+
+#include "worker_pool.h"
+
+/*
+ * Rasterizes one large picture on several threads.
+ * The output is cut into tiles and every tile plays the picture back on a worker, through a
+ * raster surface that wraps the tile's part of the destination pixels, so tiles are stitched
+ * in place without copies. The picture's R-tree limits each playback to the operations that
+ * touch its tile. Images too large to hold can be rendered as bands of tile rows instead.
+ */
+class TiledRasterizer {
+public:
+	struct Options {
+		int tileWidth = 512;
+		int tileHeight = 512;
+		SkColor background = SK_ColorWHITE;
+	};
+
+	explicit TiledRasterizer(WorkerPool& pool)
+		: fPool(pool) {}
+	TiledRasterizer(WorkerPool& pool, const Options& options)
+		: fPool(pool), fOptions(options) {}
+
+	const Options& options() const { return fOptions; }
+	void setOptions(const Options& options) { fOptions = options; }
+
+	// Plays picture back at `scale` pixels per unit into every pixel of dst
+	void render(const SkPicture& picture, float scale, const SkPixmap& dst);
+
+	// Renders a width x height N32 image one band of tile rows at a time, top to bottom.
+	// The band pixels are only valid during the call.
+	using BandFunction = std::function<void(int top, const SkPixmap& band)>;
+	void renderBands(const SkPicture& picture, float scale, int width, int height, const BandFunction& band);
+
+private:
+	// Renders dst, which shows the image from (left, top) on, and waits for all its tiles
+	void renderArea(const SkPicture& picture, float scale, int left, int top, const SkPixmap& dst);
+
+	WorkerPool& fPool;
+	Options fOptions;
+};
+
+#endif //TILED_RASTERIZER_H
@@ -0,0 +1,193 @@
+#include "typeface_registry.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+#include "include/core/SkData.h"
+
+namespace {
+
+std::string family_key(const std::string& family) {
+	std::string key;
+	key.reserve(family.size());
+	for (char ch : family) {
+		key += static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+	}
+	return key;
+}
+
+struct StyleName {
+	const char* name;
+	int weight;
+};
+
+// Style part of file names as used by Google Fonts, longest names first
+const StyleName kStyleNames[] = {
+	{"ExtraLight", SkFontStyle::kExtraLight_Weight},
+	{"ExtraBold", SkFontStyle::kExtraBold_Weight},
+	{"SemiBold", SkFontStyle::kSemiBold_Weight},
+	{"Regular", SkFontStyle::kNormal_Weight},
+	{"Medium", SkFontStyle::kMedium_Weight},
+	{"Light", SkFontStyle::kLight_Weight},
+	{"Black", SkFontStyle::kBlack_Weight},
+	{"Thin", SkFontStyle::kThin_Weight},
+	{"Bold", SkFontStyle::kBold_Weight},
+};
+
+// "Lato-BoldItalic" -> Lato, 700, italic. Without a style part the face is Regular.
+void parse_file_name(const std::string& stem, std::string* family, int* weight, SkFontStyle::Slant* slant) {
+	size_t dash = stem.rfind('-');
+	*family = stem.substr(0, dash);
+	*weight = SkFontStyle::kNormal_Weight;
+	*slant = SkFontStyle::kUpright_Slant;
+	if (dash == std::string::npos) {
+		return;
+	}
+
+	std::string style = stem.substr(dash + 1);
+	const std::string italic = "Italic";
+	if (style.size() >= italic.size() && style.compare(style.size() - italic.size(), italic.size(), italic) == 0) {
+		*slant = SkFontStyle::kItalic_Slant;
+		style.erase(style.size() - italic.size());
+	}
+	for (const StyleName& name : kStyleNames) {
+		if (style == name.name) {
+			*weight = name.weight;
+			break;
+		}
+	}
+}
+
+// Lower is better: the CSS weight search order for the desired weight
+int weight_rank(int desired, int weight) {
+	if (weight == desired) {
+		return 0;
+	}
+	if (desired >= 400 && desired <= 500) {
+		if (weight > desired && weight <= 500) {
+			return 1000 + weight - desired;
+		}
+		return weight < desired ? 2000 + desired - weight : 3000 + weight - desired;
+	}
+	if (desired < 400) {
+		return weight < desired ? 1000 + desired - weight : 2000 + weight - desired;
+	}
+	return weight > desired ? 1000 + weight - desired : 2000 + desired - weight;
+}
+
+} // namespace
+
+void TypefaceRegistry::addEmbedded(const std::string& family, int weight, SkFontStyle::Slant slant, const void* data, size_t size) {
+	add(family, {weight, slant, data, size, {}, nullptr, false});
+}
+
+void TypefaceRegistry::addFile(const std::string& family, int weight, SkFontStyle::Slant slant, const std::string& path) {
+	add(family, {weight, slant, nullptr, 0, path, nullptr, false});
+}
+
+int TypefaceRegistry::addDirectory(const std::string& path) {
+	std::error_code error;
+	std::filesystem::directory_iterator it(path, error);
+	if (error) {
+		return 0;
+	}
+
+	int count = 0;
+	for (const auto& entry : it) {
+		std::string extension = family_key(entry.path().extension().string());
+		if (!entry.is_regular_file(error) || (extension != ".ttf" && extension != ".otf")) {
+			continue;
+		}
+
+		std::string family;
+		int weight;
+		SkFontStyle::Slant slant;
+		parse_file_name(entry.path().stem().string(), &family, &weight, &slant);
+		addFile(family, weight, slant, entry.path().string());
+		++count;
+	}
+	printf("EMSC:: Registered %d fonts from %s\n", count, path.c_str());
+	return count;
+}
+
+void TypefaceRegistry::setDefaultFamily(const std::string& family) {
+	fDefaultFamily = family_key(family);
+	fMatches.clear();
+}
+
+void TypefaceRegistry::add(const std::string& family, Face face) {
+	std::string key = family_key(family);
+	if (fDefaultFamily.empty()) {
+		fDefaultFamily = key;
+	}
+
+	fFamilies[key].push_back(fFaces.size());
+	fFaces.push_back(std::move(face));
+	fMatches.clear();
+}
+
+size_t TypefaceRegistry::loadedCount() const {
+	return std::count_if(fFaces.begin(), fFaces.end(), [](const Face& face) { return face.typeface != nullptr; });
+}
+
+sk_sp<SkTypeface> TypefaceRegistry::match(const std::string& family, int weight, SkFontStyle::Slant slant) {
+	std::string key = family_key(family);
+	auto cacheKey = std::make_tuple(key, weight, static_cast<int>(slant));
+	auto it = fMatches.find(cacheKey);
+	if (it != fMatches.end()) {
+		return it->second;
+	}
+
+	sk_sp<SkTypeface> typeface = matchFamily(key, weight, slant);
+	if (!typeface && key != fDefaultFamily) {
+		typeface = matchFamily(fDefaultFamily, weight, slant);
+	}
+
+	fMatches.emplace(cacheKey, typeface);
+	return typeface;
+}
+
+sk_sp<SkTypeface> TypefaceRegistry::matchFamily(const std::string& key, int weight, SkFontStyle::Slant slant) {
+	auto family = fFamilies.find(key);
+	if (family == fFamilies.end()) {
+		return nullptr;
+	}
+
+	// Try the faces best match first, skipping those that fail to load
+	std::vector<size_t> candidates = family->second;
+	auto rank = [&](size_t index) {
+		const Face& face = fFaces[index];
+		return (face.slant == slant ? 0 : 10000) + weight_rank(weight, face.weight);
+	};
+	std::stable_sort(candidates.begin(), candidates.end(), [&](size_t a, size_t b) { return rank(a) < rank(b); });
+
+	for (size_t index : candidates) {
+		if (load(fFaces[index])) {
+			return fFaces[index].typeface;
+		}
+	}
+	return nullptr;
+}
+
+bool TypefaceRegistry::load(Face& face) {
+	if (face.typeface || face.failed) {
+		return !face.failed;
+	}
+
+	if (face.data) {
+		face.typeface = SkTypeface::MakeFromData(SkData::MakeWithoutCopy(face.data, face.size));
+	} else {
+		printf("EMSC:: Loading font %s\n", face.path.c_str());
+		face.typeface = SkTypeface::MakeFromFile(face.path.c_str());
+	}
+
+	face.failed = face.typeface == nullptr;
+	if (face.failed) {
+		printf("EMSC:: Could not load font %s\n", face.data ? "from embedded data" : face.path.c_str());
+	}
+	return !face.failed;
+}
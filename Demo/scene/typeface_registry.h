@@ -0,0 +1,62 @@
+#ifndef TYPEFACE_REGISTRY_H
+#define TYPEFACE_REGISTRY_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "include/core/SkFontStyle.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkTypeface.h"
+
+/*
+ * Typefaces by (family, weight, slant).
+ * Fonts are only registered up front, from embedded data or files, and loaded on first use,
+ * so startup does not pay for faces the scene never references. Matching follows the CSS
+ * font matching rules: slant first, then the nearest weight in the CSS search order. Unknown
+ * families, or families whose files fail to load, fall back to the default family.
+ */
+class TypefaceRegistry {
+public:
+	// The data must outlive the registry, it is not copied
+	void addEmbedded(const std::string& family, int weight, SkFontStyle::Slant slant, const void* data, size_t size);
+	void addFile(const std::string& family, int weight, SkFontStyle::Slant slant, const std::string& path);
+
+	// Registers the .ttf/.otf files of a directory named like "Lato-BoldItalic.ttf".
+	// A missing directory is not an error. Returns the number of fonts registered.
+	int addDirectory(const std::string& path);
+
+	// Family used when the requested one is unknown; defaults to the first registered family
+	void setDefaultFamily(const std::string& family);
+
+	// nullptr only when nothing at all could be loaded
+	sk_sp<SkTypeface> match(const std::string& family, int weight, SkFontStyle::Slant slant = SkFontStyle::kUpright_Slant);
+
+	size_t loadedCount() const;
+
+private:
+	struct Face {
+		int weight;
+		SkFontStyle::Slant slant;
+		const void* data;
+		size_t size;
+		std::string path;
+		sk_sp<SkTypeface> typeface;
+		bool failed;
+	};
+
+	void add(const std::string& family, Face face);
+	sk_sp<SkTypeface> matchFamily(const std::string& key, int weight, SkFontStyle::Slant slant);
+	bool load(Face& face);
+
+	std::vector<Face> fFaces;
+	// Lower-case family name -> indices in fFaces
+	std::unordered_map<std::string, std::vector<size_t>> fFamilies;
+	std::string fDefaultFamily;
+	std::map<std::tuple<std::string, int, int>, sk_sp<SkTypeface>> fMatches;
+};
+
+#endif //TYPEFACE_REGISTRY_H
@@ -0,0 +1,73 @@
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+WorkerPool::WorkerPool(int threads)
+	: fSize(threads > 0 ? threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()))) {
+	if (fSize == 1) {
+		return;
+	}
+
+	fThreads.reserve(fSize);
+	for (int i = 0; i < fSize; ++i) {
+		fThreads.emplace_back([this] { run(); });
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fStopping = true;
+	}
+	fWork.notify_all();
+	for (std::thread& thread : fThreads) {
+		thread.join();
+	}
+}
+
+void WorkerPool::submit(std::function<void()> task) {
+	if (fThreads.empty()) {
+		task();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(fMutex);
+		fTasks.push_back(std::move(task));
+	}
+	fWork.notify_one();
+}
+
+void WorkerPool::wait() {
+	std::unique_lock<std::mutex> lock(fMutex);
+	fIdle.wait(lock, [this] { return fTasks.empty() && fRunning == 0; });
+}
+
+size_t WorkerPool::queueDepth() const {
+	std::lock_guard<std::mutex> lock(fMutex);
+	return fTasks.size();
+}
+
+void WorkerPool::run() {
+	std::unique_lock<std::mutex> lock(fMutex);
+	for (;;) {
+		fWork.wait(lock, [this] { return fStopping || !fTasks.empty(); });
+		if (fTasks.empty()) {
+			return;
+		}
+
+		std::function<void()> task = std::move(fTasks.front());
+		fTasks.pop_front();
+		++fRunning;
+
+		lock.unlock();
+		task();
+		lock.lock();
+
+		--fRunning;
+		if (fTasks.empty() && fRunning == 0) {
+			fIdle.notify_all();
+		}
+	}
+}
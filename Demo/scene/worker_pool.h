@@ -0,0 +1,49 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed set of threads running submitted tasks in submission order.
+ * A pool of one thread starts no thread at all and runs each task inside submit(), so code
+ * written against the pool also runs where threads are not available. Destroying the pool
+ * finishes the queued tasks first.
+ */
+class WorkerPool {
+public:
+	// 0 uses one thread per hardware thread
+	explicit WorkerPool(int threads = 0);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	int size() const { return fSize; }
+
+	void submit(std::function<void()> task);
+	// Blocks until every task submitted so far has finished
+	void wait();
+
+	// Tasks submitted but not started yet
+	size_t queueDepth() const;
+
+private:
+	void run();
+
+	int fSize;
+	std::vector<std::thread> fThreads;
+	std::deque<std::function<void()>> fTasks;
+	mutable std::mutex fMutex;
+	std::condition_variable fWork;
+	std::condition_variable fIdle;
+	size_t fRunning = 0;
+	bool fStopping = false;
+};
+
+#endif //WORKER_POOL_H
@@ -12,7 +12,11 @@ import os
 PORT = 8000
 
 class Handler(SimpleHTTPServer.SimpleHTTPRequestHandler):
-    pass
+    # SharedArrayBuffer, and with it pthreads, needs a cross origin isolated page
+    def end_headers(self):
+        self.send_header('Cross-Origin-Opener-Policy', 'same-origin')
+        self.send_header('Cross-Origin-Embedder-Policy', 'require-corp')
+        SimpleHTTPServer.SimpleHTTPRequestHandler.end_headers(self)
 
 Handler.extensions_map['.js'] = 'application/javascript'
 # Without the correct MIME type, async compilation doesn't work
@@ -0,0 +1,242 @@
+/*
+ * Renders many scene JSON files into PNGs on a pool of worker threads.
+ *
+ *   batch_render [-o dir] [-w width] [-h height] [-s scale] [-j threads] [-z zlib] <scene.json|pattern>...
+ *
+ * Arguments are file names or glob patterns; each scene is written to dir as <name>.png.
+ * Every worker keeps its own SceneRenderer and RasterBackend, so the mapper state, fonts,
+ * caches and surface are reused between the scenes it renders and never shared. At the end
+ * the throughput and the time spent in each stage are printed.
+ *
+ * Build natively with `compile_native.sh`.
+ */
+
+#include <glob.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "include/core/SkData.h"
+
+#include "../include/struct_mapping/struct_mapping.h"
+#include "../scene/raster_backend.h"
+#include "../scene/scene_renderer.h"
+
+namespace {
+
+struct Options {
+	std::string outputDirectory = ".";
+	int width = 1280;
+	int height = 720;
+	float scale = 1;
+	int threads = 0;
+	int zlibLevel = 6;
+	std::vector<std::string> scenes;
+};
+
+enum Stage {
+	kRead,
+	kMap,
+	kCompile,
+	kRender,
+	kEncode,
+	kWrite,
+	kStageCount,
+};
+
+const char* const kStageNames[kStageCount] = {"read", "map", "compile", "render", "encode", "write"};
+
+using Clock = std::chrono::steady_clock;
+
+struct WorkerStats {
+	double stageMs[kStageCount] = {};
+	int rendered = 0;
+	int failed = 0;
+};
+
+void usage(const char* program) {
+	fprintf(stderr, "usage: %s [-o dir] [-w width] [-h height] [-s scale] [-j threads] [-z zlib] <scene.json|pattern>...\n", program);
+}
+
+// Patterns that match nothing are kept as plain names, so the error names the missing file
+void add_scenes(const char* pattern, std::vector<std::string>* scenes) {
+	glob_t matches;
+	if (glob(pattern, 0, nullptr, &matches) == 0) {
+		for (size_t i = 0; i < matches.gl_pathc; ++i) {
+			scenes->push_back(matches.gl_pathv[i]);
+		}
+	} else {
+		scenes->push_back(pattern);
+	}
+	globfree(&matches);
+}
+
+bool parse_options(int argc, char** argv, Options* options) {
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg.size() == 2 && arg[0] == '-' && i + 1 < argc) {
+			const char* value = argv[++i];
+			switch (arg[1]) {
+			case 'o': options->outputDirectory = value; break;
+			case 'w': options->width = atoi(value); break;
+			case 'h': options->height = atoi(value); break;
+			case 's': options->scale = static_cast<float>(atof(value)); break;
+			case 'j': options->threads = atoi(value); break;
+			case 'z': options->zlibLevel = atoi(value); break;
+			default: return false;
+			}
+		} else if (arg[0] == '-') {
+			return false;
+		} else {
+			add_scenes(argv[i], &options->scenes);
+		}
+	}
+
+	if (options->threads <= 0) {
+		options->threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	return !options->scenes.empty() && options->width > 0 && options->height > 0 && options->scale > 0;
+}
+
+std::string output_path(const Options& options, const std::string& scene) {
+	size_t slash = scene.find_last_of('/');
+	std::string name = slash == std::string::npos ? scene : scene.substr(slash + 1);
+	size_t dot = name.find_last_of('.');
+	if (dot != std::string::npos && dot != 0) {
+		name.resize(dot);
+	}
+	return options.outputDirectory + "/" + name + ".png";
+}
+
+class StageTimer {
+public:
+	explicit StageTimer(WorkerStats* stats)
+		: fStats(stats), fStart(Clock::now()) {}
+
+	// Charges the time since the previous mark to stage
+	void mark(Stage stage) {
+		Clock::time_point now = Clock::now();
+		fStats->stageMs[stage] += std::chrono::duration<double, std::milli>(now - fStart).count();
+		fStart = now;
+	}
+
+private:
+	WorkerStats* fStats;
+	Clock::time_point fStart;
+};
+
+bool render_scene(const Options& options, const std::string& path, SceneRenderer& scene, RasterBackend& backend, WorkerStats* stats) {
+	StageTimer timer(stats);
+
+	std::ifstream file(path, std::ios::binary);
+	std::stringstream json;
+	json << file.rdbuf();
+	timer.mark(kRead);
+	if (!file) {
+		fprintf(stderr, "%s: cannot read\n", path.c_str());
+		return false;
+	}
+
+	Elements elements;
+	try {
+		struct_mapping::map_json_to_struct(elements, json);
+	} catch (const struct_mapping::StructMappingException& e) {
+		fprintf(stderr, "%s: %s\n", path.c_str(), e.what());
+		return false;
+	}
+	timer.mark(kMap);
+
+	scene.setElements(std::move(elements));
+	timer.mark(kCompile);
+
+	backend.render(scene);
+	timer.mark(kRender);
+
+	sk_sp<SkData> png = backend.encodePNG(options.zlibLevel);
+	timer.mark(kEncode);
+	if (!png) {
+		fprintf(stderr, "%s: cannot encode\n", path.c_str());
+		return false;
+	}
+
+	std::string outputPath = output_path(options, path);
+	std::ofstream output(outputPath, std::ios::binary);
+	output.write(static_cast<const char*>(png->data()), png->size());
+	output.close();
+	timer.mark(kWrite);
+	if (!output) {
+		fprintf(stderr, "%s: cannot write %s\n", path.c_str(), outputPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parse_options(argc, argv, &options)) {
+		usage(argv[0]);
+		return 2;
+	}
+
+	const int threadCount = std::min<int>(options.threads, static_cast<int>(options.scenes.size()));
+	std::vector<WorkerStats> stats(threadCount);
+	std::atomic<size_t> next{0};
+
+	Clock::time_point start = Clock::now();
+
+	std::vector<std::thread> workers;
+	for (int i = 0; i < threadCount; ++i) {
+		workers.emplace_back([&options, &next, stats = &stats[i]] {
+			SceneRenderer scene;
+			RasterBackend backend(options.width, options.height, options.scale);
+			if (!backend.isValid()) {
+				fprintf(stderr, "cannot allocate a %dx%d surface\n", options.width, options.height);
+				return;
+			}
+
+			for (size_t index = next++; index < options.scenes.size(); index = next++) {
+				if (render_scene(options, options.scenes[index], scene, backend, stats)) {
+					++stats->rendered;
+				} else {
+					++stats->failed;
+				}
+			}
+		});
+	}
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+
+	double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	WorkerStats total;
+	for (const WorkerStats& worker : stats) {
+		total.rendered += worker.rendered;
+		total.failed += worker.failed;
+		for (int stage = 0; stage < kStageCount; ++stage) {
+			total.stageMs[stage] += worker.stageMs[stage];
+		}
+	}
+
+	printf("%d scenes rendered, %d failed, %d threads, %dx%d at scale %g\n",
+		total.rendered, total.failed, threadCount, options.width, options.height, options.scale);
+	printf("%.1f ms wall, %.1f scenes/s\n", wallMs, total.rendered / (wallMs / 1000));
+	printf("%-8s  %12s  %14s\n", "stage", "total (ms)", "per scene (ms)");
+	int processed = std::max(1, total.rendered + total.failed);
+	for (int stage = 0; stage < kStageCount; ++stage) {
+		printf("%-8s  %12.1f  %14.3f\n", kStageNames[stage], total.stageMs[stage], total.stageMs[stage] / processed);
+	}
+
+	return total.failed == 0 && total.rendered > 0 ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+/*
+ * Renders one scene JSON file into a PNG without a display or GPU.
+ *
+ *   render_scene <scene.json> <out.png> [width height [scale [threads [tile]]]]
+ *
+ * The size is in pixels and defaults to 1280x720; scale is pixels per scene unit. With more
+ * than one thread, or 0 for one per core, the image is rasterized in tiles of tile x tile
+ * pixels, 512 by default, which is how print size exports use every core.
+ * Build with `compile.sh headless` and run with node from the Demo directory, or natively
+ * with `compile_native.sh`.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "../scene/raster_backend.h"
+#include "../scene/scene_renderer.h"
+#include "../scene/tiled_rasterizer.h"
+#include "../scene/worker_pool.h"
+
+int main(int argc, char** argv) {
+	if (argc != 3 && (argc < 5 || argc > 8)) {
+		fprintf(stderr, "usage: %s <scene.json> <out.png> [width height [scale [threads [tile]]]]\n", argv[0]);
+		return 2;
+	}
+
+	int width = argc >= 5 ? atoi(argv[3]) : 1280;
+	int height = argc >= 5 ? atoi(argv[4]) : 720;
+	float scale = argc >= 6 ? static_cast<float>(atof(argv[5])) : 1.0f;
+	int threads = argc >= 7 ? atoi(argv[6]) : 1;
+	int tile = argc >= 8 ? atoi(argv[7]) : 512;
+	if (width <= 0 || height <= 0 || !(scale > 0) || threads < 0 || tile <= 0) {
+		fprintf(stderr, "invalid size %dx%d at scale %g, %d threads, %d tiles\n", width, height, scale, threads, tile);
+		return 2;
+	}
+
+	SceneRenderer scene;
+	std::string error;
+	if (!scene.loadFile(argv[1], &error)) {
+		fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+		return 1;
+	}
+
+	RasterBackend backend(width, height, scale);
+	if (!backend.isValid()) {
+		fprintf(stderr, "cannot allocate a %dx%d surface\n", width, height);
+		return 1;
+	}
+
+	if (threads == 1) {
+		backend.render(scene);
+	} else {
+		WorkerPool pool(threads);
+		TiledRasterizer::Options options;
+		options.tileWidth = tile;
+		options.tileHeight = tile;
+		TiledRasterizer tiles(pool, options);
+		backend.render(scene, tiles);
+	}
+	if (!backend.writePNG(argv[2])) {
+		fprintf(stderr, "cannot write %s\n", argv[2]);
+		return 1;
+	}
+
+	printf("%s: %zu elements -> %s (%dx%d)\n", argv[1], scene.elements().elements.size(), argv[2], width, height);
+	return 0;
+}
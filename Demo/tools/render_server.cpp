@@ -0,0 +1,710 @@
+/*
+ * Local HTTP/1.1 render service.
+ *
+ *   render_server [-b address] [-p port] [-j render threads] [-c connection threads] [-z zlib]
+ *
+ *   POST /render?width=W&height=H&scale=S&format=png|rgba   body: scene JSON
+ *   GET  /metrics                                           queue depths, counters and latencies
+ *
+ * Listens on 127.0.0.1:8080 by default. Connections are read and answered on a pool of
+ * connection threads, and their render jobs are queued for a fixed set of render workers.
+ * A keep-alive connection holds its thread only while it is busy: once accepted connections
+ * are waiting for a thread, idle and long-lived connections are closed after their response.
+ * Every worker keeps its own SceneRenderer and RasterBackend, so mapper state, fonts, text
+ * and shader caches and the surface are reused between requests. A worker that picks up a
+ * job also takes the queued jobs asking for exactly the same image and answers them with one
+ * render. RGBA responses are unpremultiplied 8 bit RGBA rows, with the size in the
+ * X-Image-Width and X-Image-Height headers.
+ *
+ * Build natively with `compile_native.sh`, then for example:
+ *   curl --data-binary @assets/sample_json.json 'localhost:8080/render?width=640&height=360' > scene.png
+ */
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "include/core/SkData.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+
+#include "../scene/raster_backend.h"
+#include "../scene/scene_renderer.h"
+#include "../scene/worker_pool.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const size_t kMaxHeaderBytes = 16 * 1024;
+const size_t kMaxBodyBytes = 16 * 1024 * 1024;
+const int kMaxDimension = 16384;
+const int64_t kMaxPixels = 64 * 1024 * 1024;
+// Idle keep-alive connections are closed after this long
+const int kReadTimeoutSeconds = 5;
+const int kMaxRequestsPerConnection = 1000;
+// A keep-alive connection is closed after its first response past this age
+const int kMaxConnectionSeconds = 60;
+// How often an idle connection checks whether other connections wait for its thread
+const int kIdlePollMs = 100;
+
+struct Options {
+	std::string address = "127.0.0.1";
+	int port = 8080;
+	int renderThreads = 0;
+	int connectionThreads = 0;
+	int zlibLevel = 6;
+};
+
+double elapsed_ms(Clock::time_point start, Clock::time_point end) {
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Latest samples of one latency, kept in a ring
+class LatencySeries {
+public:
+	void add(double ms) {
+		if (fSamples.size() < kCapacity) {
+			fSamples.push_back(ms);
+		} else {
+			fSamples[fNext] = ms;
+		}
+		fNext = (fNext + 1) % kCapacity;
+	}
+
+	double quantile(double q) const {
+		if (fSamples.empty()) {
+			return 0;
+		}
+		std::vector<double> sorted = fSamples;
+		size_t index = std::min(sorted.size() - 1, static_cast<size_t>(q * sorted.size()));
+		std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+		return sorted[index];
+	}
+
+private:
+	static constexpr size_t kCapacity = 8192;
+
+	std::vector<double> fSamples;
+	size_t fNext = 0;
+};
+
+class Metrics {
+public:
+	void requestDone(int status, double totalMs) {
+		std::lock_guard<std::mutex> lock(fMutex);
+		++fRequests;
+		if (status >= 400) {
+			++fErrors;
+		}
+		fTotal.add(totalMs);
+	}
+
+	void jobDone(double queueMs, double renderMs, size_t batchSize) {
+		std::lock_guard<std::mutex> lock(fMutex);
+		++fRenders;
+		fCoalesced += batchSize - 1;
+		fQueue.add(queueMs);
+		fRender.add(renderMs);
+	}
+
+	void queueDepth(size_t depth) {
+		std::lock_guard<std::mutex> lock(fMutex);
+		fMaxQueueDepth = std::max(fMaxQueueDepth, depth);
+	}
+
+	// Accepted connections wait in the connection pool queue until a thread picks them up
+	void connectionQueued() {
+		std::lock_guard<std::mutex> lock(fMutex);
+		++fConnections;
+		++fConnectionsWaiting;
+		fMaxConnectionsWaiting = std::max(fMaxConnectionsWaiting, fConnectionsWaiting);
+	}
+
+	void connectionStarted(double waitMs) {
+		std::lock_guard<std::mutex> lock(fMutex);
+		--fConnectionsWaiting;
+		++fConnectionsActive;
+		fConnectionWait.add(waitMs);
+	}
+
+	void connectionDone() {
+		std::lock_guard<std::mutex> lock(fMutex);
+		--fConnectionsActive;
+	}
+
+	size_t connectionsWaiting() const {
+		std::lock_guard<std::mutex> lock(fMutex);
+		return fConnectionsWaiting;
+	}
+
+	std::string text(size_t queueDepth) const {
+		std::lock_guard<std::mutex> lock(fMutex);
+		std::ostringstream out;
+		out << "render_queue_depth " << queueDepth << "\n";
+		out << "render_queue_depth_max " << fMaxQueueDepth << "\n";
+		out << "render_requests_total " << fRequests << "\n";
+		out << "render_errors_total " << fErrors << "\n";
+		out << "render_jobs_total " << fRenders << "\n";
+		out << "render_coalesced_total " << fCoalesced << "\n";
+		out << "connections_total " << fConnections << "\n";
+		out << "connections_active " << fConnectionsActive << "\n";
+		out << "connections_waiting " << fConnectionsWaiting << "\n";
+		out << "connections_waiting_max " << fMaxConnectionsWaiting << "\n";
+		writeSeries(out, "render_latency_ms", fTotal);
+		writeSeries(out, "render_queue_wait_ms", fQueue);
+		writeSeries(out, "render_job_ms", fRender);
+		writeSeries(out, "connection_wait_ms", fConnectionWait);
+		return out.str();
+	}
+
+private:
+	static void writeSeries(std::ostringstream& out, const char* name, const LatencySeries& series) {
+		for (double q : {0.5, 0.9, 0.99, 1.0}) {
+			out << name << "{quantile=\"" << q << "\"} " << series.quantile(q) << "\n";
+		}
+	}
+
+	mutable std::mutex fMutex;
+	uint64_t fRequests = 0;
+	uint64_t fErrors = 0;
+	uint64_t fRenders = 0;
+	uint64_t fCoalesced = 0;
+	size_t fMaxQueueDepth = 0;
+	uint64_t fConnections = 0;
+	size_t fConnectionsActive = 0;
+	size_t fConnectionsWaiting = 0;
+	size_t fMaxConnectionsWaiting = 0;
+	LatencySeries fTotal;
+	LatencySeries fQueue;
+	LatencySeries fRender;
+	LatencySeries fConnectionWait;
+};
+
+struct RenderRequest {
+	std::string scene;
+	int width = 1280;
+	int height = 720;
+	float scale = 1;
+	bool rgba = false;
+
+	bool sameImage(const RenderRequest& other) const {
+		return width == other.width && height == other.height && scale == other.scale
+			&& rgba == other.rgba && scene == other.scene;
+	}
+};
+
+struct RenderResult {
+	int status = 200;
+	std::string contentType;
+	std::string body;
+	int width = 0;
+	int height = 0;
+};
+
+RenderResult error_result(int status, const std::string& message) {
+	RenderResult result;
+	result.status = status;
+	result.contentType = "text/plain";
+	result.body = message + "\n";
+	return result;
+}
+
+/*
+ * Fixed set of render workers behind one job queue.
+ */
+class RenderService {
+public:
+	RenderService(int threads, int zlibLevel, Metrics& metrics)
+		: fZlibLevel(zlibLevel), fMetrics(metrics) {
+		for (int i = 0; i < threads; ++i) {
+			fThreads.emplace_back([this] { run(); });
+		}
+	}
+
+	~RenderService() {
+		{
+			std::lock_guard<std::mutex> lock(fMutex);
+			fStopping = true;
+		}
+		fWork.notify_all();
+		for (std::thread& thread : fThreads) {
+			thread.join();
+		}
+	}
+
+	// Blocks the calling connection until a worker has rendered the request
+	RenderResult render(RenderRequest request) {
+		auto job = std::make_shared<Job>();
+		job->request = std::move(request);
+		job->queued = Clock::now();
+		std::future<RenderResult> result = job->result.get_future();
+
+		size_t depth;
+		{
+			std::lock_guard<std::mutex> lock(fMutex);
+			fJobs.push_back(job);
+			depth = fJobs.size();
+		}
+		fMetrics.queueDepth(depth);
+		fWork.notify_one();
+
+		return result.get();
+	}
+
+	size_t queueDepth() const {
+		std::lock_guard<std::mutex> lock(fMutex);
+		return fJobs.size();
+	}
+
+private:
+	struct Job {
+		RenderRequest request;
+		Clock::time_point queued;
+		std::promise<RenderResult> result;
+	};
+
+	void run() {
+		// The worker's pooled context, reused by every job it renders
+		SceneRenderer scene;
+		RasterBackend backend(1, 1);
+
+		std::unique_lock<std::mutex> lock(fMutex);
+		for (;;) {
+			fWork.wait(lock, [this] { return fStopping || !fJobs.empty(); });
+			if (fJobs.empty()) {
+				return;
+			}
+
+			std::vector<std::shared_ptr<Job>> batch = {fJobs.front()};
+			fJobs.pop_front();
+			const RenderRequest& request = batch.front()->request;
+			for (auto it = fJobs.begin(); it != fJobs.end();) {
+				if ((*it)->request.sameImage(request)) {
+					batch.push_back(std::move(*it));
+					it = fJobs.erase(it);
+				} else {
+					++it;
+				}
+			}
+			lock.unlock();
+
+			Clock::time_point start = Clock::now();
+			RenderResult result = renderImage(scene, backend, request);
+			Clock::time_point end = Clock::now();
+
+			fMetrics.jobDone(elapsed_ms(batch.front()->queued, start), elapsed_ms(start, end), batch.size());
+			for (size_t i = 1; i < batch.size(); ++i) {
+				batch[i]->result.set_value(result);
+			}
+			batch.front()->result.set_value(std::move(result));
+
+			lock.lock();
+		}
+	}
+
+	RenderResult renderImage(SceneRenderer& scene, RasterBackend& backend, const RenderRequest& request) {
+		std::istringstream json(request.scene);
+		std::string error;
+		if (!scene.load(json, &error)) {
+			return error_result(400, error);
+		}
+
+		if (!backend.resize(request.width, request.height)) {
+			return error_result(500, "cannot allocate the surface");
+		}
+		backend.setScale(request.scale);
+		backend.render(scene);
+
+		RenderResult result;
+		result.width = request.width;
+		result.height = request.height;
+		if (request.rgba) {
+			SkPixmap pixels;
+			SkImageInfo info = SkImageInfo::Make(request.width, request.height, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType);
+			result.body.resize(info.computeMinByteSize());
+			if (!backend.pixels(&pixels) || !pixels.readPixels(info, &result.body[0], info.minRowBytes())) {
+				return error_result(500, "cannot read the pixels");
+			}
+			result.contentType = "application/octet-stream";
+		} else {
+			sk_sp<SkData> png = backend.encodePNG(fZlibLevel);
+			if (!png) {
+				return error_result(500, "cannot encode the image");
+			}
+			result.body.assign(static_cast<const char*>(png->data()), png->size());
+			result.contentType = "image/png";
+		}
+		return result;
+	}
+
+	int fZlibLevel;
+	Metrics& fMetrics;
+	std::vector<std::thread> fThreads;
+	std::deque<std::shared_ptr<Job>> fJobs;
+	mutable std::mutex fMutex;
+	std::condition_variable fWork;
+	bool fStopping = false;
+};
+
+struct HttpRequest {
+	std::string method;
+	std::string path;
+	std::map<std::string, std::string> query;
+	std::map<std::string, std::string> headers;
+	std::string body;
+	bool keepAlive = true;
+};
+
+std::string lower(std::string text) {
+	std::transform(text.begin(), text.end(), text.begin(), [](unsigned char ch) { return static_cast<char>(tolower(ch)); });
+	return text;
+}
+
+std::string trim(const std::string& text) {
+	size_t begin = text.find_first_not_of(" \t");
+	size_t end = text.find_last_not_of(" \t\r");
+	return begin == std::string::npos ? std::string() : text.substr(begin, end - begin + 1);
+}
+
+void parse_query(const std::string& query, std::map<std::string, std::string>* values) {
+	std::istringstream pairs(query);
+	std::string pair;
+	while (std::getline(pairs, pair, '&')) {
+		size_t equals = pair.find('=');
+		if (equals != std::string::npos) {
+			(*values)[pair.substr(0, equals)] = pair.substr(equals + 1);
+		} else if (!pair.empty()) {
+			(*values)[pair] = "";
+		}
+	}
+}
+
+// Reads one request; bytes of the next pipelined request stay in buffer.
+// Returns 0 on success, -1 when the connection closed or timed out, or an HTTP error status.
+int read_request(int fd, std::string& buffer, HttpRequest* request) {
+	size_t headerEnd;
+	char chunk[16 * 1024];
+	while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+		if (buffer.size() > kMaxHeaderBytes) {
+			return 431;
+		}
+		ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+		if (received <= 0) {
+			return -1;
+		}
+		buffer.append(chunk, static_cast<size_t>(received));
+	}
+
+	std::istringstream head(buffer.substr(0, headerEnd));
+	std::string line;
+	std::getline(head, line);
+	std::istringstream requestLine(line);
+	std::string target;
+	std::string version;
+	requestLine >> request->method >> target >> version;
+	if (request->method.empty() || target.empty() || version.compare(0, 5, "HTTP/") != 0) {
+		return 400;
+	}
+
+	size_t question = target.find('?');
+	request->path = target.substr(0, question);
+	if (question != std::string::npos) {
+		parse_query(target.substr(question + 1), &request->query);
+	}
+
+	while (std::getline(head, line)) {
+		size_t colon = line.find(':');
+		if (colon != std::string::npos) {
+			request->headers[lower(trim(line.substr(0, colon)))] = trim(line.substr(colon + 1));
+		}
+	}
+
+	std::string connection = lower(request->headers["connection"]);
+	request->keepAlive = version == "HTTP/1.1" ? connection != "close" : connection == "keep-alive";
+
+	if (request->headers.count("transfer-encoding")) {
+		return 411;
+	}
+	size_t length = 0;
+	if (request->headers.count("content-length")) {
+		char* end = nullptr;
+		unsigned long long value = strtoull(request->headers["content-length"].c_str(), &end, 10);
+		if (*end != '\0' || value > kMaxBodyBytes) {
+			return value > kMaxBodyBytes ? 413 : 400;
+		}
+		length = static_cast<size_t>(value);
+	}
+
+	buffer.erase(0, headerEnd + 4);
+	while (buffer.size() < length) {
+		ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+		if (received <= 0) {
+			return -1;
+		}
+		buffer.append(chunk, static_cast<size_t>(received));
+	}
+	request->body = buffer.substr(0, length);
+	buffer.erase(0, length);
+	return 0;
+}
+
+const char* status_text(int status) {
+	switch (status) {
+	case 200: return "OK";
+	case 400: return "Bad Request";
+	case 404: return "Not Found";
+	case 405: return "Method Not Allowed";
+	case 411: return "Length Required";
+	case 413: return "Payload Too Large";
+	case 431: return "Request Header Fields Too Large";
+	default: return "Internal Server Error";
+	}
+}
+
+bool send_all(int fd, const char* data, size_t size) {
+	while (size > 0) {
+		ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+		if (sent <= 0) {
+			return false;
+		}
+		data += sent;
+		size -= static_cast<size_t>(sent);
+	}
+	return true;
+}
+
+bool write_response(int fd, const RenderResult& result, bool keepAlive) {
+	std::ostringstream head;
+	head << "HTTP/1.1 " << result.status << " " << status_text(result.status) << "\r\n";
+	head << "Content-Type: " << result.contentType << "\r\n";
+	head << "Content-Length: " << result.body.size() << "\r\n";
+	if (result.width > 0) {
+		head << "X-Image-Width: " << result.width << "\r\n";
+		head << "X-Image-Height: " << result.height << "\r\n";
+	}
+	head << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n\r\n";
+
+	std::string headText = head.str();
+	return send_all(fd, headText.data(), headText.size()) && send_all(fd, result.body.data(), result.body.size());
+}
+
+bool parse_render_request(HttpRequest& http, RenderRequest* request, std::string* error) {
+	auto number = [&http](const char* name, double fallback) {
+		auto it = http.query.find(name);
+		return it == http.query.end() ? fallback : atof(it->second.c_str());
+	};
+
+	// Checked as doubles, casting an out of range value is undefined
+	double width = number("width", request->width);
+	double height = number("height", request->height);
+	double scale = number("scale", request->scale);
+	std::string format = http.query.count("format") ? http.query["format"] : "png";
+	request->rgba = format == "rgba";
+
+	if (format != "png" && format != "rgba") {
+		*error = "format must be png or rgba";
+		return false;
+	}
+	if (!(width >= 1 && width <= kMaxDimension) || !(height >= 1 && height <= kMaxDimension)
+		|| !(scale > 0 && scale <= std::numeric_limits<float>::max())) {
+		*error = "invalid width, height or scale";
+		return false;
+	}
+	request->width = static_cast<int>(width);
+	request->height = static_cast<int>(height);
+	request->scale = static_cast<float>(scale);
+	if (int64_t(request->width) * request->height > kMaxPixels) {
+		*error = "invalid width, height or scale";
+		return false;
+	}
+
+	request->scene = std::move(http.body);
+	return true;
+}
+
+// Waits up to the read timeout for the next keep-alive request to start arriving. Returns false
+// to close the connection, also as soon as other connections are waiting for a thread.
+bool wait_for_request(int fd, const std::string& buffer, Metrics& metrics) {
+	// A pipelined request is already buffered
+	if (!buffer.empty()) {
+		return true;
+	}
+
+	Clock::time_point deadline = Clock::now() + std::chrono::seconds(kReadTimeoutSeconds);
+	while (Clock::now() < deadline) {
+		pollfd ready = {fd, POLLIN, 0};
+		int count = poll(&ready, 1, kIdlePollMs);
+		if (count > 0) {
+			return true;
+		}
+		if (count < 0 && errno != EINTR) {
+			return false;
+		}
+		if (metrics.connectionsWaiting() > 0) {
+			return false;
+		}
+	}
+	return false;
+}
+
+void handle_connection(int fd, Clock::time_point accepted, RenderService& service, Metrics& metrics) {
+	Clock::time_point opened = Clock::now();
+	metrics.connectionStarted(elapsed_ms(accepted, opened));
+
+	timeval timeout = {kReadTimeoutSeconds, 0};
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	std::string buffer;
+	for (int served = 0; served < kMaxRequestsPerConnection; ++served) {
+		// The first request is read right away, the client connected to send it
+		if (served > 0 && !wait_for_request(fd, buffer, metrics)) {
+			break;
+		}
+
+		HttpRequest http;
+		int status = read_request(fd, buffer, &http);
+		if (status < 0) {
+			break;
+		}
+		Clock::time_point start = Clock::now();
+
+		RenderResult result;
+		if (status != 0) {
+			result = error_result(status, status_text(status));
+			http.keepAlive = false;
+		} else if (http.path == "/metrics") {
+			result.contentType = "text/plain";
+			result.body = metrics.text(service.queueDepth());
+		} else if (http.path != "/render") {
+			result = error_result(404, "unknown path " + http.path);
+		} else if (http.method != "POST") {
+			result = error_result(405, "POST the scene JSON to /render");
+		} else {
+			RenderRequest request;
+			std::string error;
+			result = parse_render_request(http, &request, &error) ? service.render(std::move(request)) : error_result(400, error);
+		}
+
+		// Hand the thread over to waiting connections, the client reconnects for its next request
+		if (served + 1 == kMaxRequestsPerConnection || metrics.connectionsWaiting() > 0
+			|| Clock::now() - opened > std::chrono::seconds(kMaxConnectionSeconds)) {
+			http.keepAlive = false;
+		}
+
+		bool written = write_response(fd, result, http.keepAlive);
+		if (http.path != "/metrics") {
+			metrics.requestDone(result.status, elapsed_ms(start, Clock::now()));
+		}
+		if (!written || !http.keepAlive) {
+			break;
+		}
+	}
+	close(fd);
+	metrics.connectionDone();
+}
+
+bool parse_options(int argc, char** argv, Options* options) {
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string flag = argv[i];
+		const char* value = argv[i + 1];
+		if (flag == "-b") {
+			options->address = value;
+		} else if (flag == "-p") {
+			options->port = atoi(value);
+		} else if (flag == "-j") {
+			options->renderThreads = atoi(value);
+		} else if (flag == "-c") {
+			options->connectionThreads = atoi(value);
+		} else if (flag == "-z") {
+			options->zlibLevel = atoi(value);
+		} else {
+			return false;
+		}
+	}
+	if (argc % 2 == 0) {
+		return false;
+	}
+
+	if (options->renderThreads <= 0) {
+		options->renderThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+	// Connection threads mostly wait, on the network or for a render worker
+	if (options->connectionThreads <= 0) {
+		options->connectionThreads = options->renderThreads * 4 + 4;
+	}
+	options->connectionThreads = std::max(2, options->connectionThreads);
+	return options->port > 0 && options->port < 65536;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parse_options(argc, argv, &options)) {
+		fprintf(stderr, "usage: %s [-b address] [-p port] [-j render threads] [-c connection threads] [-z zlib]\n", argv[0]);
+		return 2;
+	}
+	signal(SIGPIPE, SIG_IGN);
+
+	int listener = socket(AF_INET, SOCK_STREAM, 0);
+	int reuse = 1;
+	setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(static_cast<uint16_t>(options.port));
+	if (inet_pton(AF_INET, options.address.c_str(), &address.sin_addr) != 1
+		|| bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+		|| listen(listener, 128) != 0) {
+		fprintf(stderr, "cannot listen on %s:%d: %s\n", options.address.c_str(), options.port, strerror(errno));
+		return 1;
+	}
+
+	Metrics metrics;
+	RenderService service(options.renderThreads, options.zlibLevel, metrics);
+	WorkerPool connections(options.connectionThreads);
+	printf("listening on %s:%d with %d render and %d connection threads\n",
+		options.address.c_str(), options.port, options.renderThreads, options.connectionThreads);
+	fflush(stdout);
+
+	for (;;) {
+		int fd = accept(listener, nullptr, nullptr);
+		if (fd < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			perror("accept");
+			break;
+		}
+		Clock::time_point accepted = Clock::now();
+		metrics.connectionQueued();
+		connections.submit([fd, accepted, &service, &metrics] { handle_connection(fd, accepted, service, metrics); });
+	}
+
+	close(listener);
+	return 1;
+}
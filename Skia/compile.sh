@@ -40,7 +40,7 @@ echo "Compiling skia libraries..."
   ar=\"${EMAR}\" \
   extra_cflags_cc=[\"-frtti\"] \
   extra_cflags=[\"-s\", \"WARN_UNALIGNED=1\", \"-s\", \"MAIN_MODULE=1\",
-    \"-DSKNX_NO_SIMD\", \"-DSK_DISABLE_AAA\", \"-DSK_DISABLE_LEGACY_SHADERCONTEXT\",
+    \"-pthread\", \"-DSKNX_NO_SIMD\", \"-DSK_DISABLE_AAA\", \"-DSK_DISABLE_LEGACY_SHADERCONTEXT\",
     ${EXTRA_CFLAGS}
   ] \
   ${IS_SKIA_DEBUG} 